@@ -1,7 +1,7 @@
 #include "Account.h"
 
 Account::Account(const std::string& number, const std::string& holder, long long initialBalance)
-    : accountNumber(number), accountHolder(holder), balanceCents(initialBalance) {}
+    : accountNumber(number), accountHolder(holder), balanceCents(initialBalance), heldCents(0) {}
 
 std::string Account::getAccountNumber() const {
     return accountNumber;
@@ -15,6 +15,14 @@ long long Account::getBalance() const {
     return balanceCents;
 }
 
+long long Account::getHeldBalance() const {
+    return heldCents;
+}
+
+long long Account::getAvailableBalance() const {
+    return balanceCents - heldCents;
+}
+
 void Account::deposit(long long amountCents) {
     if (amountCents > 0) {
         balanceCents += amountCents;
@@ -22,13 +30,25 @@ void Account::deposit(long long amountCents) {
 }
 
 bool Account::withdraw(long long amountCents) {
-    if (amountCents > 0 && balanceCents >= amountCents) {
+    if (amountCents > 0 && balanceCents - heldCents >= amountCents) {
         balanceCents -= amountCents;
         return true;
     }
     return false;
 }
 
+bool Account::hold(long long amountCents) {
+    if (amountCents > 0 && balanceCents - heldCents >= amountCents) {
+        heldCents += amountCents;
+        return true;
+    }
+    return false;
+}
+
+void Account::releaseHeld(long long amountCents) {
+    heldCents -= amountCents;
+}
+
 void Account::addBalance(long long amountCents) {
     balanceCents += amountCents;
 }
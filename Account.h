@@ -9,6 +9,7 @@ private:
     std::string accountNumber;
     std::string accountHolder;
     long long balanceCents;  // Using cents (integers) to avoid floating-point precision issues
+    long long heldCents;     // Reserved by open authorization holds
     
 public:
     // Constructor
@@ -18,10 +19,16 @@ public:
     std::string getAccountNumber() const;
     std::string getAccountHolder() const;
     long long getBalance() const;
+    long long getHeldBalance() const;
+    long long getAvailableBalance() const;  // Balance minus open holds
     
     // Balance operations
     void deposit(long long amountCents);
-    bool withdraw(long long amountCents);  // Returns false if insufficient funds
+    bool withdraw(long long amountCents);  // Returns false if insufficient available funds
+    
+    // Authorization holds
+    bool hold(long long amountCents);      // Returns false if insufficient available funds
+    void releaseHeld(long long amountCents);
     
     // Used for atomic transactions
     void addBalance(long long amountCents);      // Internal method for rollback
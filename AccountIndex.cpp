@@ -0,0 +1,83 @@
+#include "AccountIndex.h"
+#include <cctype>
+
+std::string AccountIndex::foldCase(const std::string& text) {
+    std::string folded(text);
+    for (char& c : folded) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return folded;
+}
+
+void AccountIndex::accountAdded(const Account& account) {
+    byHolder.emplace(foldCase(account.getAccountHolder()), &account);
+    byBalance.emplace(account.getBalance(), &account);
+}
+
+void AccountIndex::balanceChanged(const Account& account, long long previousBalanceCents) {
+    const long long balance = account.getBalance();
+    if (balance == previousBalanceCents) {
+        return;
+    }
+    
+    // Move the existing node to its new key instead of reallocating it
+    auto node = byBalance.extract(std::make_pair(previousBalanceCents, &account));
+    if (node.empty()) {
+        byBalance.emplace(balance, &account);
+        return;
+    }
+    node.value().first = balance;
+    byBalance.insert(std::move(node));
+}
+
+void AccountIndex::rebuildBalances(const std::vector<std::pair<long long, const Account*>>& sortedEntries) {
+    // Sorted input makes every insertion an O(1) append at the end hint;
+    // the old tree's nodes are reused rather than freed and reallocated
+    std::set<std::pair<long long, const Account*>> rebuilt;
+    for (const auto& entry : sortedEntries) {
+        if (byBalance.empty()) {
+            rebuilt.emplace_hint(rebuilt.end(), entry);
+            continue;
+        }
+        auto node = byBalance.extract(byBalance.begin());
+        node.value() = entry;
+        rebuilt.insert(rebuilt.end(), std::move(node));
+    }
+    byBalance.swap(rebuilt);
+}
+
+std::vector<const Account*> AccountIndex::findByHolderPrefix(const std::string& prefix, std::size_t limit) const {
+    std::vector<const Account*> matches;
+    const std::string folded = foldCase(prefix);
+    
+    for (auto it = byHolder.lower_bound(std::make_pair(folded, static_cast<const Account*>(nullptr)));
+         it != byHolder.end() && matches.size() < limit; ++it) {
+        if (it->first.compare(0, folded.size(), folded) != 0) {
+            break;  // Past the last name with this prefix
+        }
+        matches.push_back(it->second);
+    }
+    return matches;
+}
+
+std::vector<const Account*> AccountIndex::largestBalances(std::size_t count) const {
+    std::vector<const Account*> largest;
+    for (auto it = byBalance.rbegin(); it != byBalance.rend() && largest.size() < count; ++it) {
+        largest.push_back(it->second);
+    }
+    return largest;
+}
+
+std::vector<const Account*> AccountIndex::balancesInRange(long long minCents, long long maxCents,
+                                                       std::size_t limit) const {
+    std::vector<const Account*> inRange;
+    for (auto it = byBalance.lower_bound(std::make_pair(minCents, static_cast<const Account*>(nullptr)));
+         it != byBalance.end() && it->first <= maxCents && inRange.size() < limit; ++it) {
+        inRange.push_back(it->second);
+    }
+    return inRange;
+}
+
+std::size_t AccountIndex::size() const {
+    return byBalance.size();
+}
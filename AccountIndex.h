@@ -0,0 +1,48 @@
+#ifndef ACCOUNTINDEX_H
+#define ACCOUNTINDEX_H
+
+#include "Account.h"
+#include <cstddef>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Secondary indexes over the ledger's accounts, maintained incrementally:
+// holder name (case-insensitive prefix search) and balance (top-N and
+// range queries). Both are ordered trees, so every update is O(log n) and
+// every query is O(log n + results). Entries point at the ledger's own
+// Account objects, which never move, to keep tree nodes small.
+class AccountIndex {
+private:
+    std::set<std::pair<std::string, const Account*>> byHolder;   // (folded holder name, account)
+    std::set<std::pair<long long, const Account*>> byBalance;    // (balance, account)
+    
+public:
+    static constexpr bool kEnabled = true;
+    
+    void accountAdded(const Account& account);
+    
+    // Re-files the account after its balance moved away from `previousBalanceCents`
+    void balanceChanged(const Account& account, long long previousBalanceCents);
+    
+    // Replaces the balance index in one linear pass, for updates that touch
+    // most accounts. `sortedEntries` must hold every indexed account once,
+    // sorted by (balance, account).
+    void rebuildBalances(const std::vector<std::pair<long long, const Account*>>& sortedEntries);
+    
+    // Accounts whose holder name starts with `prefix` (case-insensitive), by name
+    std::vector<const Account*> findByHolderPrefix(const std::string& prefix, std::size_t limit) const;
+    
+    // The `count` largest balances, largest first
+    std::vector<const Account*> largestBalances(std::size_t count) const;
+    
+    // Accounts with minCents <= balance <= maxCents, smallest first
+    std::vector<const Account*> balancesInRange(long long minCents, long long maxCents, std::size_t limit) const;
+    
+    std::size_t size() const;
+    
+    static std::string foldCase(const std::string& text);
+};
+
+#endif // ACCOUNTINDEX_H
@@ -0,0 +1,103 @@
+#include "AccountTimeline.h"
+#include <algorithm>
+
+void AccountTimeline::accountOpened(const std::string& accountNumber, long long openingBalanceCents,
+                                    std::time_t openedAt) {
+    Timeline& timeline = timelines[accountNumber];
+    if (timeline.entryCount == 0) {
+        timeline.opened = true;
+        timeline.openingBalanceCents = openingBalanceCents;
+        timeline.openedAt = openedAt;
+    }
+}
+
+void AccountTimeline::entryAppended(const Transaction& txn, std::size_t entryIndex) {
+    if (nextEntry.size() <= entryIndex) {
+        nextEntry.resize(entryIndex + 1, kNoEntry);
+    }
+    link(timelines[txn.getAccountNumber()], txn, entryIndex);
+}
+
+void AccountTimeline::reserveEntries(std::size_t entryCount) {
+    if (nextEntry.size() < entryCount) {
+        nextEntry.resize(entryCount, kNoEntry);
+    }
+}
+
+void AccountTimeline::linkEntries(const std::vector<Transaction>& entries, std::size_t first, std::size_t last) {
+    // find() never inserts, so concurrent batches only touch their own timelines
+    // Consecutive entries usually belong to the same account: look it up once
+    Timeline* timeline = nullptr;
+    std::string accountNumber;
+    for (std::size_t i = first; i < last; ++i) {
+        const Transaction& txn = entries[i];
+        std::string entryAccount = txn.getAccountNumber();
+        if (!timeline || entryAccount != accountNumber) {
+            auto it = timelines.find(entryAccount);
+            timeline = (it == timelines.end()) ? nullptr : &it->second;
+            accountNumber = std::move(entryAccount);
+        }
+        if (timeline) {
+            link(*timeline, txn, i);
+        }
+    }
+}
+
+void AccountTimeline::link(Timeline& timeline, const Transaction& txn, std::size_t entryIndex) {
+    if (timeline.lastEntry != kNoEntry) {
+        nextEntry[timeline.lastEntry] = entryIndex;
+    } else {
+        timeline.firstEntry = entryIndex;
+    }
+    if (timeline.entryCount % kCheckpointInterval == 0) {
+        timeline.checkpoints.push_back(Checkpoint{txn.getTimestamp(), entryIndex});
+    }
+    timeline.lastEntry = entryIndex;
+    ++timeline.entryCount;
+}
+
+bool AccountTimeline::balanceAt(const std::vector<Transaction>& entries, const std::string& accountNumber,
+                                std::time_t timestamp, long long& balanceCents) const {
+    auto it = timelines.find(accountNumber);
+    if (it == timelines.end()) {
+        return false;
+    }
+    const Timeline& timeline = it->second;
+    
+    // Last checkpoint at or before `timestamp`
+    auto checkpoint = std::upper_bound(timeline.checkpoints.begin(), timeline.checkpoints.end(), timestamp,
+                                       [](std::time_t t, const Checkpoint& c) { return t < c.timestamp; });
+    if (checkpoint == timeline.checkpoints.begin()) {
+        // Before the account's first entry: only the opening balance applies
+        if (!timeline.opened || timestamp < timeline.openedAt) {
+            return false;
+        }
+        balanceCents = timeline.openingBalanceCents;
+        return true;
+    }
+    --checkpoint;
+    
+    // Replay forward to the last entry at or before `timestamp`
+    std::size_t entry = checkpoint->entryIndex;
+    for (std::size_t next = nextEntry[entry];
+         next != kNoEntry && next < entries.size() && entries[next].getTimestamp() <= timestamp;
+         next = nextEntry[next]) {
+        entry = next;
+    }
+    balanceCents = entries[entry].getBalanceAfter();
+    return true;
+}
+
+std::vector<std::size_t> AccountTimeline::entriesFor(const std::string& accountNumber) const {
+    std::vector<std::size_t> indices;
+    auto it = timelines.find(accountNumber);
+    if (it == timelines.end()) {
+        return indices;
+    }
+    
+    indices.reserve(it->second.entryCount);
+    for (std::size_t entry = it->second.firstEntry; entry != kNoEntry; entry = nextEntry[entry]) {
+        indices.push_back(entry);
+    }
+    return indices;
+}
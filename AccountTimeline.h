@@ -0,0 +1,67 @@
+#ifndef ACCOUNTTIMELINE_H
+#define ACCOUNTTIMELINE_H
+
+#include "Transaction.h"
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Per-account navigation over an append-only transaction history.
+//
+// Every entry links to the same account's next entry, and every
+// kCheckpointInterval-th entry of an account is checkpointed with its
+// timestamp. balanceAt() binary-searches an account's checkpoints and then
+// replays at most kCheckpointInterval linked entries, reading the running
+// balance each entry carries. Timestamps are assumed non-decreasing per
+// account, which holds for entries appended as they happen.
+class AccountTimeline {
+public:
+    static constexpr std::size_t kCheckpointInterval = 64;
+    static constexpr std::size_t kNoEntry = static_cast<std::size_t>(-1);
+    
+private:
+    struct Checkpoint {
+        std::time_t timestamp;
+        std::size_t entryIndex;
+    };
+    
+    struct Timeline {
+        bool opened = false;            // Opening balance known
+        long long openingBalanceCents = 0;
+        std::time_t openedAt = 0;
+        std::size_t entryCount = 0;
+        std::size_t firstEntry = kNoEntry;
+        std::size_t lastEntry = kNoEntry;
+        std::vector<Checkpoint> checkpoints;
+    };
+    
+    std::unordered_map<std::string, Timeline> timelines;
+    std::vector<std::size_t> nextEntry;  // Parallel to the history: same account's next entry
+    
+    void link(Timeline& timeline, const Transaction& txn, std::size_t entryIndex);
+    
+public:
+    void accountOpened(const std::string& accountNumber, long long openingBalanceCents, std::time_t openedAt);
+    
+    // Must be called for each history entry, in order, with its index
+    void entryAppended(const Transaction& txn, std::size_t entryIndex);
+    
+    // Bulk alternative to entryAppended() for entries appended together:
+    // reserveEntries() with the new history size, then linkEntries() once per
+    // batch. Batches that share no account may be linked concurrently; every
+    // account must already have been opened.
+    void reserveEntries(std::size_t entryCount);
+    void linkEntries(const std::vector<Transaction>& entries, std::size_t first, std::size_t last);
+    
+    // Balance of `accountNumber` as of `timestamp` (inclusive). Returns false
+    // if the account did not exist yet or its history is unknown.
+    bool balanceAt(const std::vector<Transaction>& entries, const std::string& accountNumber,
+                   std::time_t timestamp, long long& balanceCents) const;
+    
+    // Indices of the account's entries, oldest first
+    std::vector<std::size_t> entriesFor(const std::string& accountNumber) const;
+};
+
+#endif // ACCOUNTTIMELINE_H
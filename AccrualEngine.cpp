@@ -0,0 +1,80 @@
+#include "AccrualEngine.h"
+#include <algorithm>
+#include <thread>
+
+AccrualEngine::AccrualEngine(const RateSchedule& rateSchedule) : schedule(rateSchedule) {
+    std::sort(schedule.tiers.begin(), schedule.tiers.end(),
+              [](const RateTier& a, const RateTier& b) { return a.minBalanceCents < b.minBalanceCents; });
+}
+
+long long AccrualEngine::mulDivRoundHalfEven(long long value, long long numerator, long long denominator) {
+    if (value < 0) {
+        return -mulDivRoundHalfEven(-value, numerator, denominator);
+    }
+    
+    // Split value = q * denominator + r so the products stay within 64 bits
+    long long q = value / denominator;
+    long long r = value % denominator;
+    long long result = q * numerator + (r * numerator) / denominator;
+    long long remainder = (r * numerator) % denominator;
+    
+    // Banker's rounding: exact halves go to the even neighbour
+    if (remainder * 2 > denominator || (remainder * 2 == denominator && (result & 1))) {
+        ++result;
+    }
+    return result;
+}
+
+long long AccrualEngine::interestFor(long long balanceCents) const {
+    if (balanceCents <= 0 || schedule.tiers.empty()) {
+        return 0;
+    }
+    
+    // Highest tier whose threshold the balance reaches
+    auto tier = std::upper_bound(schedule.tiers.begin(), schedule.tiers.end(), balanceCents,
+                                 [](long long balance, const RateTier& t) { return balance < t.minBalanceCents; });
+    if (tier == schedule.tiers.begin()) {
+        return 0;
+    }
+    --tier;
+    
+    return mulDivRoundHalfEven(balanceCents,
+                               static_cast<long long>(tier->annualRateBasisPoints) * schedule.accrualDays,
+                               10000LL * schedule.daysInYear);
+}
+
+long long AccrualEngine::feeFor(long long balanceCents) const {
+    if (!schedule.chargeMonthlyFee || balanceCents >= schedule.feeWaiverBalanceCents) {
+        return 0;
+    }
+    return schedule.monthlyFeeCents;
+}
+
+std::size_t AccrualEngine::rangesFor(std::size_t count, unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return std::max<std::size_t>(1, std::min<std::size_t>(threads, count));
+}
+
+void AccrualEngine::parallelFor(std::size_t count, unsigned threads,
+                                const std::function<void(std::size_t, std::size_t, std::size_t)>& work) {
+    const std::size_t ranges = rangesFor(count, threads);
+    const std::size_t chunk = (count + ranges - 1) / ranges;
+    
+    if (ranges == 1) {
+        work(0, count, 0);
+        return;
+    }
+    
+    std::vector<std::thread> workers;
+    workers.reserve(ranges);
+    for (std::size_t i = 0; i < ranges; ++i) {
+        std::size_t begin = std::min(count, i * chunk);
+        std::size_t end = std::min(count, begin + chunk);
+        workers.emplace_back(work, begin, end, i);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef ACCRUALENGINE_H
+#define ACCRUALENGINE_H
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <vector>
+
+// Interest tier: applies to balances at or above `minBalanceCents`
+struct RateTier {
+    long long minBalanceCents;
+    int annualRateBasisPoints;  // 725 = 7.25% per year
+};
+
+struct RateSchedule {
+    std::vector<RateTier> tiers;    // Highest matching tier wins
+    int daysInYear = 365;
+    int accrualDays = 1;            // Days of interest posted by this run
+    bool chargeMonthlyFee = false;
+    long long monthlyFeeCents = 0;
+    long long feeWaiverBalanceCents = std::numeric_limits<long long>::max();  // No fee at or above this
+};
+
+struct AccrualSummary {
+    std::size_t accountsProcessed = 0;
+    std::size_t interestPostings = 0;
+    std::size_t feePostings = 0;
+    std::size_t failedFees = 0;     // Fees not charged because funds were insufficient
+    long long totalInterestCents = 0;
+    long long totalFeesCents = 0;
+};
+
+// Integer fixed-point interest and fee calculation for end-of-day batches.
+// All arithmetic is in cents; fractional cents use banker's rounding.
+class AccrualEngine {
+private:
+    RateSchedule schedule;
+    
+public:
+    explicit AccrualEngine(const RateSchedule& rateSchedule);
+    
+    // Interest for `accrualDays` on a balance; zero for non-positive balances
+    long long interestFor(long long balanceCents) const;
+    
+    // Monthly fee due on a balance (zero when waived or not charged this run)
+    long long feeFor(long long balanceCents) const;
+    
+    // value * numerator / denominator, rounded half to even
+    static long long mulDivRoundHalfEven(long long value, long long numerator, long long denominator);
+    
+    // Number of ranges parallelFor() will use for `count` items
+    static std::size_t rangesFor(std::size_t count, unsigned threads);
+    
+    // Splits [0, count) into rangesFor(count, threads) contiguous ranges and
+    // runs work(begin, end, rangeIndex) on each, one thread per range
+    static void parallelFor(std::size_t count, unsigned threads,
+                            const std::function<void(std::size_t, std::size_t, std::size_t)>& work);
+};
+
+#endif // ACCRUALENGINE_H
@@ -0,0 +1,377 @@
+#include "AsyncLogWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define ASYNCLOG_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+#ifdef ASYNCLOG_IO_URING
+// Minimal io_uring ring driven through the raw system calls, so there is no
+// dependency on liburing. Only the writer thread touches it.
+struct AsyncLogWriter::UringQueue {
+    int ringFd = -1;
+    void* sqRing = MAP_FAILED;
+    std::size_t sqRingSize = 0;
+    void* cqRing = MAP_FAILED;
+    std::size_t cqRingSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    std::size_t sqesSize = 0;
+    
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    
+    ~UringQueue() {
+        if (sqes != MAP_FAILED) {
+            munmap(sqes, sqesSize);
+        }
+        if (cqRing != MAP_FAILED && cqRing != sqRing) {
+            munmap(cqRing, cqRingSize);
+        }
+        if (sqRing != MAP_FAILED) {
+            munmap(sqRing, sqRingSize);
+        }
+        if (ringFd >= 0) {
+            close(ringFd);
+        }
+    }
+    
+    bool setup(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ringFd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ringFd < 0) {
+            return false;  // Old kernel, or blocked by a sandbox
+        }
+        
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) {
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+        
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) {
+            return false;
+        }
+        cqRing = singleMap ? sqRing
+                           : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            return false;
+        }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                                MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+        
+        char* sq = static_cast<char*>(sqRing);
+        char* cq = static_cast<char*>(cqRing);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+    
+    io_uring_sqe* nextSqe(unsigned& tail) {
+        unsigned index = tail & *sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray[index] = index;
+        ++tail;
+        return sqe;
+    }
+    
+    // Writes [data, data + length) at `offset` and then fdatasyncs, as one
+    // linked submission. Returns the bytes written (a short write cancels
+    // the sync: `synced` is false) or -errno.
+    long long writeAndSync(int fd, const char* data, std::size_t length, std::uint64_t offset, bool& synced) {
+        unsigned tail = *sqTail;
+        io_uring_sqe* write = nextSqe(tail);
+        write->opcode = IORING_OP_WRITE;
+        write->fd = fd;
+        write->off = offset;
+        write->addr = reinterpret_cast<std::uint64_t>(data);
+        write->len = static_cast<std::uint32_t>(std::min<std::size_t>(length, 1u << 30));
+        write->flags = IOSQE_IO_LINK;
+        write->user_data = 1;
+        
+        io_uring_sqe* sync = nextSqe(tail);
+        sync->opcode = IORING_OP_FSYNC;
+        sync->fd = fd;
+        sync->fsync_flags = IORING_FSYNC_DATASYNC;
+        sync->user_data = 2;
+        __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+        
+        long long written = -EIO;
+        int syncResult = -EIO;
+        unsigned toSubmit = 2;
+        unsigned reaped = 0;
+        while (reaped < 2) {
+            long entered = syscall(__NR_io_uring_enter, ringFd, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (entered < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -errno;
+            }
+            toSubmit -= std::min<unsigned>(toSubmit, static_cast<unsigned>(entered));
+            
+            unsigned head = *cqHead;
+            unsigned available = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            for (; head != available; ++head, ++reaped) {
+                const io_uring_cqe& cqe = cqes[head & *cqMask];
+                if (cqe.user_data == 1) {
+                    written = cqe.res;
+                } else {
+                    syncResult = cqe.res;
+                }
+            }
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        }
+        
+        synced = (syncResult == 0);
+        if (written >= 0 && static_cast<std::size_t>(written) == length && syncResult < 0) {
+            return syncResult;  // Everything written but the sync failed
+        }
+        return written;
+    }
+};
+#else
+struct AsyncLogWriter::UringQueue {};
+#endif
+
+AsyncLogWriter::AsyncLogWriter(const std::string& path, bool truncate, std::size_t bufferBytes,
+                               Backend preferred)
+    : filePath(path), fd(-1), backend(Backend::PWRITE), fileOffset(0),
+      bufferCapacity(std::max<std::size_t>(bufferBytes, 4096)), active(0),
+      appendedSequence(0), durableSequence(0), failed(false), stopping(false) {
+#ifdef _WIN32
+    fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | (truncate ? _O_TRUNC : _O_APPEND),
+               _S_IREAD | _S_IWRITE);
+#else
+    fd = open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+#endif
+    if (fd < 0) {
+        std::cerr << "Error opening " << filePath << " for writing." << std::endl;
+        return;
+    }
+    
+#ifdef _WIN32
+    fileOffset = static_cast<std::uint64_t>(_lseeki64(fd, 0, SEEK_END));
+#else
+    fileOffset = static_cast<std::uint64_t>(lseek(fd, 0, SEEK_END));
+#endif
+    
+#ifdef ASYNCLOG_IO_URING
+    if (preferred == Backend::IO_URING) {
+        uring.reset(new UringQueue());
+        if (uring->setup(4)) {
+            backend = Backend::IO_URING;
+        } else {
+            uring.reset();
+        }
+    }
+#else
+    (void)preferred;
+#endif
+    
+    staging[0].reserve(bufferCapacity);
+    staging[1].reserve(bufferCapacity);
+    writer = std::thread(&AsyncLogWriter::run, this);
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        workAvailable.notify_one();
+        writer.join();
+    }
+    uring.reset();
+    if (fd >= 0) {
+#ifdef _WIN32
+        _close(fd);
+#else
+        close(fd);
+#endif
+    }
+}
+
+bool AsyncLogWriter::isOpen() const {
+    return fd >= 0;
+}
+
+AsyncLogWriter::Backend AsyncLogWriter::getBackend() const {
+    return backend;
+}
+
+void AsyncLogWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        workAvailable.wait(lock, [this] { return !staging[active].empty() || stopping; });
+        if (staging[active].empty()) {
+            return;  // Stopping, and everything has been written
+        }
+        
+        // Swap: appends continue into the other (empty) buffer during the I/O
+        std::vector<char>& batch = staging[active];
+        active ^= 1;
+        const std::uint64_t batchEnd = appendedSequence;
+        const bool skip = failed;
+        lock.unlock();
+        spaceAvailable.notify_all();  // Appends blocked on a full buffer can fill the empty one now
+        
+        bool ok = !skip && writeBatch(batch.data(), batch.size());
+        
+        lock.lock();
+        batch.clear();
+        if (ok) {
+            durableSequence = batchEnd;
+        } else {
+            failed = true;
+            spaceAvailable.notify_all();
+        }
+        batchCompleted.notify_all();
+    }
+}
+
+bool AsyncLogWriter::writeBatch(const char* data, std::size_t length) {
+#ifdef ASYNCLOG_IO_URING
+    if (backend == Backend::IO_URING) {
+        while (length > 0) {
+            bool synced = false;
+            long long written = uring->writeAndSync(fd, data, length, fileOffset, synced);
+            if (written == -EINVAL || written == -EOPNOTSUPP) {
+                // The kernel has io_uring but not these opcodes
+                backend = Backend::PWRITE;
+                return writeBatchPwrite(data, length);
+            }
+            if (written < 0) {
+                std::cerr << "Error writing " << filePath << ": " << std::strerror(static_cast<int>(-written))
+                          << std::endl;
+                return false;
+            }
+            data += written;
+            length -= static_cast<std::size_t>(written);
+            fileOffset += static_cast<std::uint64_t>(written);
+            if (length == 0 && !synced) {
+                std::cerr << "Error syncing " << filePath << "." << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+#endif
+    return writeBatchPwrite(data, length);
+}
+
+bool AsyncLogWriter::writeBatchPwrite(const char* data, std::size_t length) {
+    while (length > 0) {
+#ifdef _WIN32
+        long long written = _write(fd, data, static_cast<unsigned int>(std::min<std::size_t>(length, 1u << 30)));
+#else
+        long long written = pwrite(fd, data, length, static_cast<off_t>(fileOffset));
+#endif
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Error writing " << filePath << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        data += written;
+        length -= static_cast<std::size_t>(written);
+        fileOffset += static_cast<std::uint64_t>(written);
+    }
+    
+#if defined(_WIN32)
+    bool synced = _commit(fd) == 0;
+#elif defined(__APPLE__)
+    bool synced = fsync(fd) == 0;
+#else
+    bool synced = fdatasync(fd) == 0;
+#endif
+    if (!synced) {
+        std::cerr << "Error syncing " << filePath << ": " << std::strerror(errno) << std::endl;
+    }
+    return synced;
+}
+
+std::uint64_t AsyncLogWriter::append(const char* data, std::size_t length) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (fd < 0) {
+        return 0;
+    }
+    
+    // Back-pressure: only when the active buffer is full while the other is on its way to disk
+    spaceAvailable.wait(lock, [&] {
+        return failed || staging[active].empty() || staging[active].size() + length <= bufferCapacity;
+    });
+    if (failed) {
+        return 0;
+    }
+    
+    std::vector<char>& buffer = staging[active];
+    const bool wasEmpty = buffer.empty();
+    buffer.insert(buffer.end(), data, data + length);
+    const std::uint64_t sequence = ++appendedSequence;
+    lock.unlock();
+    
+    if (wasEmpty) {
+        workAvailable.notify_one();
+    }
+    return sequence;
+}
+
+std::uint64_t AsyncLogWriter::append(const std::string& record) {
+    return append(record.data(), record.size());
+}
+
+bool AsyncLogWriter::waitDurable(std::uint64_t sequence) {
+    std::unique_lock<std::mutex> lock(mutex);
+    sequence = std::min(sequence, appendedSequence);
+    batchCompleted.wait(lock, [&] { return durableSequence >= sequence || failed; });
+    return durableSequence >= sequence;
+}
+
+std::uint64_t AsyncLogWriter::getAppendedSequence() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return appendedSequence;
+}
+
+std::uint64_t AsyncLogWriter::getDurableSequence() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return durableSequence;
+}
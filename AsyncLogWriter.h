@@ -0,0 +1,85 @@
+#ifndef ASYNCLOGWRITER_H
+#define ASYNCLOGWRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Append-only file writer that keeps disk latency off the caller's thread.
+//
+// append() copies a record into the active one of two staging buffers and
+// returns its sequence number. A background thread swaps the buffers
+// whenever it is idle, writes the full one at the end of the file and makes
+// it durable (fdatasync). On Linux the write and the sync go to the kernel
+// as one linked io_uring submission; where io_uring is unavailable the
+// thread uses pwrite() and fdatasync(). While one buffer is being written
+// the next batch fills the other, so append() only waits for the disk when
+// both are full, and every waitDurable() caller covered by a batch shares
+// its single sync.
+class AsyncLogWriter {
+public:
+    enum class Backend {
+        IO_URING,
+        PWRITE
+    };
+    
+private:
+    struct UringQueue;  // Defined in AsyncLogWriter.cpp (Linux only)
+    
+    std::string filePath;
+    int fd;
+    std::atomic<Backend> backend;          // Falls back to PWRITE if io_uring rejects a write
+    std::unique_ptr<UringQueue> uring;
+    std::uint64_t fileOffset;       // Written by the writer thread only
+    std::size_t bufferCapacity;
+    
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;   // Active buffer became non-empty, or stopping
+    std::condition_variable batchCompleted;  // A batch finished (durable or failed)
+    std::condition_variable spaceAvailable;  // Buffers swapped (the active one is empty), or a write failed
+    std::vector<char> staging[2];
+    int active;                              // Buffer receiving appends
+    std::uint64_t appendedSequence;
+    std::uint64_t durableSequence;
+    bool failed;
+    bool stopping;
+    std::thread writer;
+    
+    void run();
+    bool writeBatch(const char* data, std::size_t length);
+    bool writeBatchPwrite(const char* data, std::size_t length);
+    
+public:
+    // Opens (truncating, or appending to) `path` and starts the writer thread.
+    // `preferred` IO_URING still falls back to PWRITE where io_uring is
+    // unavailable; PWRITE skips io_uring altogether.
+    explicit AsyncLogWriter(const std::string& path, bool truncate = true, std::size_t bufferBytes = 4 << 20,
+                            Backend preferred = Backend::IO_URING);
+    ~AsyncLogWriter();  // Writes out everything appended, then stops
+    
+    AsyncLogWriter(const AsyncLogWriter&) = delete;
+    AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+    
+    bool isOpen() const;
+    Backend getBackend() const;
+    
+    // Queues bytes for writing. Returns their sequence number (1, 2, ...),
+    // or 0 if the file is not open or a write has failed.
+    std::uint64_t append(const char* data, std::size_t length);
+    std::uint64_t append(const std::string& record);
+    
+    // Blocks until every append up to `sequence` is on stable storage.
+    // Returns false if a write failed first.
+    bool waitDurable(std::uint64_t sequence);
+    
+    std::uint64_t getAppendedSequence() const;
+    std::uint64_t getDurableSequence() const;
+};
+
+#endif // ASYNCLOGWRITER_H
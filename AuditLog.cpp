@@ -0,0 +1,638 @@
+#include "AuditLog.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+const std::size_t HASH_SUFFIX_LENGTH = 65;  // " " + 64 hex digits
+
+Sha256::Digest leafHash(const char* record, std::size_t length) {
+    static const std::uint8_t kLeafPrefix = 0x00;
+    Sha256 hasher;
+    hasher.update(&kLeafPrefix, 1);
+    hasher.update(record, length);
+    return hasher.finish();
+}
+
+Sha256::Digest chainHash(const Sha256::Digest& previous, const Sha256::Digest& leaf) {
+    std::uint8_t message[64];
+    std::copy(previous.begin(), previous.end(), message);
+    std::copy(leaf.begin(), leaf.end(), message + 32);
+    return Sha256::hash(message, sizeof(message));
+}
+
+// RFC 6962: split at the largest power of two below the leaf count
+Sha256::Digest merkleRoot(const Sha256::Digest* leaves, std::size_t count) {
+    if (count == 0) {
+        return Sha256().finish();
+    }
+    if (count == 1) {
+        return leaves[0];
+    }
+    
+    std::size_t split = 1;
+    while (split * 2 < count) {
+        split *= 2;
+    }
+    Sha256::Digest left = merkleRoot(leaves, split);
+    Sha256::Digest right = merkleRoot(leaves + split, count - split);
+    
+    static const std::uint8_t kNodePrefix = 0x01;
+    Sha256 hasher;
+    hasher.update(&kNodePrefix, 1);
+    hasher.update(left.data(), left.size());
+    hasher.update(right.data(), right.size());
+    return hasher.finish();
+}
+
+// Reads the chain hash stored at the end of a line (without its newline)
+bool parseChainHash(const char* line, std::size_t length, Sha256::Digest& stored) {
+    return length >= HASH_SUFFIX_LENGTH && line[length - HASH_SUFFIX_LENGTH] == ' ' &&
+           Sha256::fromHex(line + length - HASH_SUFFIX_LENGTH + 1, HASH_SUFFIX_LENGTH - 1, stored);
+}
+
+// Walks the records in `text` (whole lines), checking each stored chain hash
+// against the chain continued from `chain`. On success `chain` holds the new
+// head. On failure `badRecord` is the offending record's index within `text`.
+// Unchained lines (a genesis segment) are whole records with no stored hash.
+bool verifyLines(const std::string& text, Sha256::Digest& chain, std::uint64_t& records,
+                 std::vector<Sha256::Digest>* leaves, std::uint64_t& badRecord, std::string& problem,
+                 bool chained = true) {
+    records = 0;
+    std::size_t lineStart = 0;
+    while (lineStart < text.size()) {
+        std::size_t lineEnd = text.find('\n', lineStart);
+        if (lineEnd == std::string::npos) {
+            badRecord = records;
+            problem = "incomplete last record";
+            return false;
+        }
+        
+        std::size_t length = lineEnd - lineStart;
+        if (!chained) {
+            Sha256::Digest leaf = leafHash(text.data() + lineStart, length);
+            chain = chainHash(chain, leaf);
+            if (leaves) {
+                leaves->push_back(leaf);
+            }
+            ++records;
+            lineStart = lineEnd + 1;
+            continue;
+        }
+        
+        Sha256::Digest stored;
+        if (!parseChainHash(text.data() + lineStart, length, stored)) {
+            badRecord = records;
+            problem = "record has no chain hash";
+            return false;
+        }
+        
+        Sha256::Digest leaf = leafHash(text.data() + lineStart, length - HASH_SUFFIX_LENGTH);
+        chain = chainHash(chain, leaf);
+        if (chain != stored) {
+            badRecord = records;
+            problem = "chain hash mismatch";
+            return false;
+        }
+        if (leaves) {
+            leaves->push_back(leaf);
+        }
+        
+        ++records;
+        lineStart = lineEnd + 1;
+    }
+    return true;
+}
+
+bool readRange(const std::string& path, std::uint64_t offset, std::uint64_t length, std::string& text) {
+    text.clear();
+    if (length == 0) {
+        return true;
+    }
+    
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    text.resize(length);
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(&text[0], static_cast<std::streamsize>(length));
+    return file.gcount() == static_cast<std::streamsize>(length);
+}
+
+// The line ending at `end` (just past its newline), without the newline
+std::string readLastLine(const std::string& path, std::uint64_t end) {
+    std::string text;
+    std::uint64_t start = end;
+    while (start > 0) {
+        std::uint64_t chunk = std::min<std::uint64_t>(start, 4096);
+        std::string earlier;
+        if (!readRange(path, start - chunk, chunk, earlier)) {
+            return "";
+        }
+        start -= chunk;
+        text.insert(0, earlier);
+        std::size_t newline = text.size() >= 2 ? text.rfind('\n', text.size() - 2) : std::string::npos;
+        if (newline != std::string::npos) {
+            return text.substr(newline + 1, text.size() - newline - 2);
+        }
+    }
+    return text.empty() ? text : text.substr(0, text.size() - 1);
+}
+
+// True if any line of `text` ends in something shaped like a chain hash.
+// A log written before the hash chain has none.
+bool hasChainedLine(const std::string& text) {
+    std::size_t lineStart = 0;
+    while (lineStart < text.size()) {
+        std::size_t lineEnd = std::min(text.find('\n', lineStart), text.size());
+        Sha256::Digest stored;
+        if (parseChainHash(text.data() + lineStart, lineEnd - lineStart, stored)) {
+            return true;
+        }
+        lineStart = lineEnd + 1;
+    }
+    return false;
+}
+
+void writeCheckpointHeader(std::ostream& out, const std::string& logFile) {
+    out << "# Audit checkpoints for " << logFile << " - DO NOT EDIT" << '\n';
+    out << "# Format: FirstRecord RecordCount ByteOffset ByteLength StartHash EndHash MerkleRoot [genesis]" << '\n';
+}
+
+std::string formatCheckpoint(const AuditCheckpoint& checkpoint) {
+    std::ostringstream line;
+    line << checkpoint.firstRecord << ' ' << checkpoint.recordCount << ' '
+         << checkpoint.byteOffset << ' ' << checkpoint.byteLength << ' '
+         << Sha256::toHex(checkpoint.startHash) << ' ' << Sha256::toHex(checkpoint.endHash) << ' '
+         << Sha256::toHex(checkpoint.merkleRoot);
+    if (checkpoint.genesis) {
+        line << " genesis";
+    }
+    return line.str();
+}
+
+// Loads "<log>.audit" and checks that consecutive checkpoints link up
+bool readCheckpoints(const std::string& path, std::vector<AuditCheckpoint>& checkpoints, std::string& problem) {
+    checkpoints.clear();
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return true;  // No segment sealed yet
+    }
+    
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        
+        std::istringstream iss(line);
+        AuditCheckpoint checkpoint;
+        std::string start, end, root;
+        if (!(iss >> checkpoint.firstRecord >> checkpoint.recordCount >> checkpoint.byteOffset
+                  >> checkpoint.byteLength >> start >> end >> root) ||
+            !Sha256::fromHex(start, checkpoint.startHash) || !Sha256::fromHex(end, checkpoint.endHash) ||
+            !Sha256::fromHex(root, checkpoint.merkleRoot)) {
+            problem = "malformed checkpoint " + std::to_string(checkpoints.size());
+            return false;
+        }
+        std::string kind;
+        if (iss >> kind) {
+            if (kind != "genesis" || !checkpoints.empty()) {
+                problem = "malformed checkpoint " + std::to_string(checkpoints.size());
+                return false;
+            }
+            checkpoint.genesis = true;  // Only the first segment can be legacy
+        }
+        
+        AuditCheckpoint expected;  // What the previous checkpoint implies
+        if (!checkpoints.empty()) {
+            const AuditCheckpoint& previous = checkpoints.back();
+            expected.firstRecord = previous.firstRecord + previous.recordCount;
+            expected.byteOffset = previous.byteOffset + previous.byteLength;
+            expected.startHash = previous.endHash;
+        }
+        if (checkpoint.firstRecord != expected.firstRecord || checkpoint.byteOffset != expected.byteOffset ||
+            checkpoint.startHash != expected.startHash || checkpoint.recordCount == 0) {
+            problem = "checkpoint " + std::to_string(checkpoints.size()) + " does not follow the previous one";
+            return false;
+        }
+        checkpoints.push_back(checkpoint);
+    }
+    return true;
+}
+
+} // namespace
+
+// ==================== Writer ====================
+
+AuditLogWriter::AuditLogWriter(const std::string& logFile, std::size_t segmentSize)
+    : logFilePath(logFile), checkpointFilePath(checkpointPathFor(logFile)),
+      segmentRecords(segmentSize > 0 ? segmentSize : 1), head{}, records(0), bytes(0) {}
+
+AuditLogWriter::~AuditLogWriter() {
+    close();
+}
+
+std::string AuditLogWriter::checkpointPathFor(const std::string& logFile) {
+    return logFile + ".audit";
+}
+
+bool AuditLogWriter::recover() {
+    // open() creates the checkpoint file before the first append, so a log
+    // with records but no checkpoint file either predates the hash chain
+    // or lost its checkpoints. Neither is adopted silently.
+    std::error_code error;
+    if (!std::filesystem::exists(checkpointFilePath) && std::filesystem::exists(logFilePath) &&
+        std::filesystem::file_size(logFilePath, error) > 0) {
+        std::cerr << logFilePath << " has records but no checkpoint file " << checkpointFilePath
+                  << "; refusing to append. A log written before the hash chain must first be sealed "
+                  << "with audit_verify --migrate-legacy." << std::endl;
+        return false;
+    }
+    
+    std::string problem;
+    std::vector<AuditCheckpoint> sealed;
+    if (!readCheckpoints(checkpointFilePath, sealed, problem)) {
+        std::cerr << checkpointFilePath << ": " << problem << std::endl;
+        return false;
+    }
+    
+    head = Sha256::Digest{};
+    records = 0;
+    bytes = 0;
+    if (!sealed.empty()) {
+        head = sealed.back().endHash;
+        records = sealed.back().firstRecord + sealed.back().recordCount;
+        bytes = sealed.back().byteOffset + sealed.back().byteLength;
+    }
+    
+    // Re-hash the unsealed tail to rebuild the open segment
+    std::uint64_t fileSize = std::filesystem::exists(logFilePath) ? std::filesystem::file_size(logFilePath, error) : 0;
+    if (error || fileSize < bytes) {
+        std::cerr << logFilePath << " is shorter than its audit checkpoints." << std::endl;
+        return false;
+    }
+    
+    std::string tail;
+    if (!readRange(logFilePath, bytes, fileSize - bytes, tail)) {
+        std::cerr << "Error reading " << logFilePath << std::endl;
+        return false;
+    }
+    
+    // A crash can leave the last record half-written. It never got its
+    // newline, so everything up to the last newline must still verify.
+    const std::size_t complete = tail.rfind('\n') + 1;  // 0 if there is no newline at all
+    const std::size_t torn = tail.size() - complete;
+    tail.resize(complete);
+    
+    segment = AuditCheckpoint{};
+    segment.firstRecord = records;
+    segment.byteOffset = bytes;
+    segment.startHash = head;
+    segmentLeaves.clear();
+    
+    std::uint64_t tailRecords = 0;
+    std::uint64_t badRecord = 0;
+    if (!verifyLines(tail, head, tailRecords, &segmentLeaves, badRecord, problem)) {
+        std::cerr << logFilePath << " record " << (records + badRecord) << ": " << problem
+                  << "; refusing to append to a log that does not verify." << std::endl;
+        return false;
+    }
+    records += tailRecords;
+    
+    if (torn > 0) {
+        fileSize = bytes + complete;
+        std::filesystem::resize_file(logFilePath, fileSize, error);
+        if (error) {
+            std::cerr << "Error truncating the incomplete last record of " << logFilePath << ": "
+                      << error.message() << std::endl;
+            return false;
+        }
+        std::cerr << "Warning: " << logFilePath << " ended with an incomplete record; truncated " << torn
+                  << " bytes back to record " << records << " at byte " << fileSize << "." << std::endl;
+    }
+    bytes = fileSize;
+    segment.recordCount = tailRecords;
+    
+    lastRecord.clear();
+    if (records > 0) {
+        // Genesis lines carry no chain hash
+        lastRecord = readLastLine(logFilePath, bytes);
+        bool chained = tailRecords > 0 || !sealed.back().genesis;
+        if (chained && lastRecord.size() >= HASH_SUFFIX_LENGTH) {
+            lastRecord.resize(lastRecord.size() - HASH_SUFFIX_LENGTH);
+        }
+    }
+    segment.byteLength = fileSize - segment.byteOffset;
+    return true;
+}
+
+// The lines stay as they are and the chain continues from the genesis
+// segment's end hash
+bool AuditLogWriter::migrateLegacyLog(const std::string& logFile) {
+    const std::string checkpointFile = checkpointPathFor(logFile);
+    if (std::filesystem::exists(checkpointFile)) {
+        std::cerr << logFile << " already has a checkpoint file " << checkpointFile << "; nothing to migrate."
+                  << std::endl;
+        return false;
+    }
+    
+    std::error_code error;
+    std::uint64_t fileSize = std::filesystem::file_size(logFile, error);
+    std::string text;
+    if (error || !readRange(logFile, 0, fileSize, text)) {
+        std::cerr << "Error reading " << logFile << std::endl;
+        return false;
+    }
+    if (text.empty()) {
+        std::cerr << logFile << " is empty; nothing to migrate." << std::endl;
+        return false;
+    }
+    // A chained log whose checkpoints were deleted must not be re-sealed
+    // as trusted, whatever happened to its first line
+    if (hasChainedLine(text)) {
+        std::cerr << logFile << " has chain hashes, so it is not a legacy log; refusing to migrate it." << std::endl;
+        return false;
+    }
+    if (text.back() != '\n') {
+        // New records must start on a line of their own
+        std::ofstream file(logFile, std::ios::app | std::ios::binary);
+        file << '\n';
+        file.close();
+        if (!file.good()) {
+            std::cerr << "Error opening " << logFile << " for writing." << std::endl;
+            return false;
+        }
+        text += '\n';
+    }
+    
+    AuditCheckpoint genesis;
+    genesis.genesis = true;
+    genesis.byteLength = text.size();
+    std::vector<Sha256::Digest> leaves;
+    std::uint64_t badRecord = 0;
+    std::string problem;
+    verifyLines(text, genesis.endHash, genesis.recordCount, &leaves, badRecord, problem, false);
+    genesis.merkleRoot = merkleRoot(leaves.data(), leaves.size());
+    
+    std::ofstream file(checkpointFile);
+    writeCheckpointHeader(file, logFile);
+    file << formatCheckpoint(genesis) << '\n';
+    file.close();
+    if (!file.good()) {
+        std::cerr << "Error opening " << checkpointFile << " for writing." << std::endl;
+        return false;
+    }
+    
+    std::cerr << "Migrated legacy log " << logFile << ": sealed " << genesis.recordCount << " records ("
+              << genesis.byteLength << " bytes) as a genesis segment." << std::endl;
+    return true;
+}
+
+bool AuditLogWriter::open() {
+    if (!recover()) {
+        return false;
+    }
+    
+    log.reset(new AsyncLogWriter(logFilePath, false));
+    if (!log->isOpen()) {
+        log.reset();
+        return false;
+    }
+    
+    checkpoints.open(checkpointFilePath, std::ios::app | std::ios::ate);
+    if (!checkpoints.is_open()) {
+        std::cerr << "Error opening " << checkpointFilePath << " for writing." << std::endl;
+        log.reset();
+        return false;
+    }
+    if (checkpoints.tellp() == 0) {
+        writeCheckpointHeader(checkpoints, logFilePath);
+        checkpoints.flush();
+    }
+    
+    // Seal a tail that was already full when the previous writer stopped
+    if (segment.recordCount >= segmentRecords) {
+        return sealSegment(0) && writeCheckpoints(false);
+    }
+    return checkpoints.good();
+}
+
+bool AuditLogWriter::append(const std::string& record) {
+    if (!log) {
+        std::cerr << "Audit log " << logFilePath << " is not open." << std::endl;
+        return false;
+    }
+    if (record.find('\n') != std::string::npos) {
+        std::cerr << "Audit log records must be single lines." << std::endl;
+        return false;
+    }
+    
+    Sha256::Digest leaf = leafHash(record.data(), record.size());
+    head = chainHash(head, leaf);
+    segmentLeaves.push_back(leaf);
+    
+    std::string line;
+    line.reserve(record.size() + HASH_SUFFIX_LENGTH + 1);
+    line += record;
+    line += ' ';
+    line += Sha256::toHex(head);
+    line += '\n';
+    std::uint64_t sequence = log->append(line);
+    if (sequence == 0) {
+        return false;
+    }
+    
+    ++records;
+    bytes += line.size();
+    lastRecord = record;
+    ++segment.recordCount;
+    segment.byteLength += line.size();
+    
+    if (segment.recordCount >= segmentRecords && !sealSegment(sequence)) {
+        return false;
+    }
+    return writeCheckpoints(false);
+}
+
+bool AuditLogWriter::sealSegment(std::uint64_t lastSequence) {
+    segment.endHash = head;
+    segment.merkleRoot = merkleRoot(segmentLeaves.data(), segmentLeaves.size());
+    sealedSegments.emplace_back(lastSequence, segment);
+    
+    segment = AuditCheckpoint{};
+    segment.firstRecord = records;
+    segment.byteOffset = bytes;
+    segment.startHash = head;
+    segmentLeaves.clear();
+    return true;
+}
+
+// Writes the checkpoints whose segments are durable. With `waitForDisk`,
+// first waits for everything appended so far.
+bool AuditLogWriter::writeCheckpoints(bool waitForDisk) {
+    if (sealedSegments.empty()) {
+        return true;
+    }
+    if (waitForDisk && !log->waitDurable(sealedSegments.back().first)) {
+        return false;
+    }
+    
+    std::uint64_t durable = log->getDurableSequence();
+    std::size_t written = 0;
+    while (written < sealedSegments.size() && sealedSegments[written].first <= durable) {
+        checkpoints << formatCheckpoint(sealedSegments[written].second) << '\n';
+        ++written;
+    }
+    if (written == 0) {
+        return true;
+    }
+    sealedSegments.erase(sealedSegments.begin(), sealedSegments.begin() + static_cast<std::ptrdiff_t>(written));
+    checkpoints.flush();
+    return checkpoints.good();
+}
+
+bool AuditLogWriter::flush() {
+    if (!log) {
+        return true;
+    }
+    if (!log->waitDurable(log->getAppendedSequence())) {
+        return false;
+    }
+    return writeCheckpoints(true);
+}
+
+bool AuditLogWriter::close() {
+    if (!log) {
+        return true;
+    }
+    bool ok = flush();
+    log.reset();
+    checkpoints.close();
+    return ok;
+}
+
+const Sha256::Digest& AuditLogWriter::getHead() const {
+    return head;
+}
+
+std::uint64_t AuditLogWriter::getRecordCount() const {
+    return records;
+}
+
+const std::string& AuditLogWriter::getLastRecord() const {
+    return lastRecord;
+}
+
+// ==================== Verification ====================
+
+bool verifyAuditLog(const std::string& logFile, unsigned threads, AuditVerifyReport& report) {
+    report = AuditVerifyReport{};
+    
+    std::error_code error;
+    std::uint64_t fileSize = std::filesystem::file_size(logFile, error);
+    if (error) {
+        report.problem = "cannot read " + logFile;
+        return false;
+    }
+    
+    // The writer creates the checkpoint file before its first record
+    const std::string checkpointFile = AuditLogWriter::checkpointPathFor(logFile);
+    if (fileSize > 0 && !std::filesystem::exists(checkpointFile)) {
+        report.problem = "log has records but no checkpoint file " + checkpointFile;
+        return false;
+    }
+    std::vector<AuditCheckpoint> sealed;
+    if (!readCheckpoints(checkpointFile, sealed, report.problem)) {
+        return false;
+    }
+    std::uint64_t sealedBytes = sealed.empty() ? 0 : sealed.back().byteOffset + sealed.back().byteLength;
+    if (fileSize < sealedBytes) {
+        report.problem = "log is shorter than its checkpoints (truncated)";
+        return false;
+    }
+    
+    // Sealed segments are independent: each worker claims the next one
+    struct SegmentResult {
+        bool ok = false;
+        std::uint64_t badRecord = 0;  // Absolute record number
+        std::string problem;
+    };
+    std::vector<SegmentResult> results(sealed.size());
+    std::atomic<std::size_t> nextSegment(0);
+    auto worker = [&]() {
+        std::string text;
+        std::vector<Sha256::Digest> leaves;
+        for (std::size_t i = nextSegment++; i < sealed.size(); i = nextSegment++) {
+            const AuditCheckpoint& checkpoint = sealed[i];
+            SegmentResult& result = results[i];
+            result.badRecord = checkpoint.firstRecord;
+            if (!readRange(logFile, checkpoint.byteOffset, checkpoint.byteLength, text)) {
+                result.problem = "cannot read segment";
+                continue;
+            }
+            
+            Sha256::Digest chain = checkpoint.startHash;
+            std::uint64_t count = 0;
+            std::uint64_t badRecord = 0;
+            leaves.clear();
+            if (!verifyLines(text, chain, count, &leaves, badRecord, result.problem, !checkpoint.genesis)) {
+                result.badRecord = checkpoint.firstRecord + badRecord;
+            } else if (count != checkpoint.recordCount || chain != checkpoint.endHash) {
+                result.problem = "segment does not match its checkpoint";
+            } else if (merkleRoot(leaves.data(), leaves.size()) != checkpoint.merkleRoot) {
+                result.problem = "Merkle root mismatch";
+            } else {
+                result.ok = true;
+            }
+        }
+    };
+    
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::size_t workerCount = std::min<std::size_t>(threads, sealed.size());
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    
+    for (std::size_t i = 0; i < sealed.size(); ++i) {
+        if (!results[i].ok) {
+            report.segments = i;
+            report.records = sealed[i].firstRecord;
+            report.firstBadRecord = results[i].badRecord;
+            report.problem = "segment " + std::to_string(i) + ": " + results[i].problem;
+            return false;
+        }
+    }
+    report.segments = sealed.size();
+    
+    // Then the unsealed tail, continuing the chain from the last checkpoint
+    std::string tail;
+    if (!readRange(logFile, sealedBytes, fileSize - sealedBytes, tail)) {
+        report.problem = "cannot read " + logFile;
+        return false;
+    }
+    report.head = sealed.empty() ? Sha256::Digest{} : sealed.back().endHash;
+    report.records = sealed.empty() ? 0 : sealed.back().firstRecord + sealed.back().recordCount;
+    std::uint64_t tailRecords = 0;
+    std::uint64_t badRecord = 0;
+    if (!verifyLines(tail, report.head, tailRecords, nullptr, badRecord, report.problem)) {
+        report.firstBadRecord = report.records + badRecord;
+        report.problem = "unsealed tail: " + report.problem;
+        return false;
+    }
+    report.records += tailRecords;
+    report.intact = true;
+    return true;
+}
@@ -0,0 +1,115 @@
+#ifndef AUDITLOG_H
+#define AUDITLOG_H
+
+#include "AsyncLogWriter.h"
+#include "Sha256.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Tamper-evident, hash-chained text log.
+//
+// Each record is written as one line followed by a space and its chain hash:
+//   leaf[i]  = SHA-256(0x00 || record[i])
+//   chain[i] = SHA-256(chain[i-1] || leaf[i]),  chain[-1] = 32 zero bytes
+// Every `segmentRecords` records are sealed into a checkpoint in
+// "<log>.audit": where the segment lies in the log, the chain hash before
+// and after it, and the Merkle root of its leaves (RFC 6962 tree shape).
+// A log written before the chain existed (no "<log>.audit" and no chain
+// hashes) can be adopted once, explicitly, by sealing its lines as they
+// are into a genesis segment: its records are leaf-hashed and chained like
+// any other, only the per-line hashes are missing.
+// Segments verify independently, so verification runs on every core and
+// only the checkpoints need to be checked in order. Editing any record
+// breaks the chain from that record on. A log whose whole chain was
+// recomputed is caught by comparing the head hash with a copy kept
+// elsewhere.
+//
+// Records go to disk through an AsyncLogWriter, so append() does not wait
+// for the disk. A checkpoint is only written once every byte of its
+// segment is durable, so "<log>.audit" never refers to data a crash could
+// still lose.
+
+struct AuditCheckpoint {
+    std::uint64_t firstRecord = 0;
+    std::uint64_t recordCount = 0;
+    std::uint64_t byteOffset = 0;   // Segment position in the log file
+    std::uint64_t byteLength = 0;
+    Sha256::Digest startHash{};     // Chain hash before the segment's first record
+    Sha256::Digest endHash{};       // Chain hash after its last record
+    Sha256::Digest merkleRoot{};
+    bool genesis = false;           // Legacy lines without chain hashes, sealed on migration
+};
+
+struct AuditVerifyReport {
+    bool intact = false;
+    std::uint64_t records = 0;
+    std::size_t segments = 0;       // Sealed segments checked
+    std::uint64_t firstBadRecord = std::numeric_limits<std::uint64_t>::max();  // If known
+    std::string problem;
+    Sha256::Digest head{};          // Chain hash after the last record
+};
+
+class AuditLogWriter {
+private:
+    std::string logFilePath;
+    std::string checkpointFilePath;
+    std::size_t segmentRecords;
+    std::unique_ptr<AsyncLogWriter> log;
+    std::ofstream checkpoints;
+    std::vector<std::pair<std::uint64_t, AuditCheckpoint>> sealedSegments;  // Awaiting durability: (last log sequence, checkpoint)
+    Sha256::Digest head;
+    std::uint64_t records;
+    std::uint64_t bytes;
+    AuditCheckpoint segment;                   // The open (unsealed) segment
+    std::vector<Sha256::Digest> segmentLeaves;
+    std::string lastRecord;
+    
+    bool recover();
+    bool sealSegment(std::uint64_t lastSequence);
+    bool writeCheckpoints(bool waitForDisk);
+    
+public:
+    explicit AuditLogWriter(const std::string& logFile = "transactions.log", std::size_t segmentSize = 4096);
+    ~AuditLogWriter();
+    
+    // Opens the log for appending. An existing log is re-hashed from its
+    // last checkpoint to pick up the chain; a log that does not verify
+    // there is refused, as is a log with records but no "<log>.audit".
+    // An incomplete last record (torn by a crash) is truncated away with a
+    // warning.
+    bool open();
+    
+    // Appends one record (a single line of text)
+    bool append(const std::string& record);
+    
+    // Waits until every appended record is durable and writes the pending
+    // checkpoints. A partial last segment stays chained and is sealed once
+    // later appends fill it.
+    bool flush();
+    bool close();
+    
+    const Sha256::Digest& getHead() const;
+    std::uint64_t getRecordCount() const;
+    
+    // The newest record, without its chain hash; empty if there is none
+    const std::string& getLastRecord() const;
+    
+    static std::string checkpointPathFor(const std::string& logFile);
+    
+    // One-time migration of a log written before the hash chain: seals all
+    // of it into a genesis segment so writers can append to it. Refuses a
+    // log that already has "<log>.audit" or any chain hash in it.
+    static bool migrateLegacyLog(const std::string& logFile);
+};
+
+// Verifies the chain, every sealed segment (in parallel over `threads`
+// workers; 0 = all cores) and the unsealed tail. Returns report.intact.
+bool verifyAuditLog(const std::string& logFile, unsigned threads, AuditVerifyReport& report);
+
+#endif // AUDITLOG_H
@@ -0,0 +1,46 @@
+#include "AuthorizationHolds.h"
+#include <algorithm>
+
+std::uint64_t AuthorizationHolds::open(Account& account, long long amountCents, std::time_t expiresAt) {
+    const std::uint64_t holdId = nextHoldId++;
+    std::uint64_t deadline = static_cast<std::uint64_t>(std::max<std::time_t>(expiresAt, 0));
+    TimerWheel::TimerId timer = expiry.schedule(deadline, holdId);
+    holds.emplace(holdId, OpenHold{Hold{&account, amountCents}, timer});
+    return holdId;
+}
+
+const AuthorizationHolds::Hold* AuthorizationHolds::find(std::uint64_t holdId) const {
+    auto it = holds.find(holdId);
+    return it == holds.end() ? nullptr : &it->second.hold;
+}
+
+bool AuthorizationHolds::close(std::uint64_t holdId, Hold& hold) {
+    auto it = holds.find(holdId);
+    if (it == holds.end()) {
+        return false;
+    }
+    
+    expiry.cancel(it->second.expiryTimer);
+    hold = it->second.hold;
+    holds.erase(it);
+    return true;
+}
+
+const std::vector<std::pair<std::uint64_t, AuthorizationHolds::Hold>>& AuthorizationHolds::expire(std::time_t now) {
+    expired.clear();
+    if (holds.empty() || now < 0) {
+        return expired;
+    }
+    
+    dueIds.clear();
+    expiry.advance(static_cast<std::uint64_t>(now), dueIds);
+    for (std::uint64_t holdId : dueIds) {
+        auto it = holds.find(holdId);
+        if (it == holds.end()) {
+            continue;
+        }
+        expired.emplace_back(holdId, it->second.hold);
+        holds.erase(it);
+    }
+    return expired;
+}
@@ -0,0 +1,56 @@
+#ifndef AUTHORIZATIONHOLDS_H
+#define AUTHORIZATIONHOLDS_H
+
+#include "Account.h"
+#include "TimerWheel.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Book of open authorization holds, keyed by hold ID. Expiry is driven by
+// a timer wheel ticking in seconds, so expiring holds never scans. Only
+// tracks holds: reserving and releasing the funds on the Account is the
+// ledger's job.
+class AuthorizationHolds {
+public:
+    struct Hold {
+        Account* account;
+        long long amountCents;
+    };
+    
+private:
+    struct OpenHold {
+        Hold hold;
+        TimerWheel::TimerId expiryTimer;
+    };
+    
+    std::unordered_map<std::uint64_t, OpenHold> holds;
+    TimerWheel expiry{static_cast<std::uint64_t>(std::time(nullptr))};
+    std::vector<std::uint64_t> dueIds;                     // Scratch buffers for expire()
+    std::vector<std::pair<std::uint64_t, Hold>> expired;
+    std::uint64_t nextHoldId = 1;
+    
+public:
+    static constexpr bool kEnabled = true;
+    
+    bool empty() const { return holds.empty(); }
+    std::size_t size() const { return holds.size(); }
+    
+    // Tracks funds already reserved on `account`; returns the new hold's ID
+    std::uint64_t open(Account& account, long long amountCents, std::time_t expiresAt);
+    
+    // The open hold `holdId`, or nullptr if unknown, settled or expired
+    const Hold* find(std::uint64_t holdId) const;
+    
+    // Stops tracking `holdId` and cancels its expiry; false if it is not open
+    bool close(std::uint64_t holdId, Hold& hold);
+    
+    // Stops tracking every hold due at or before `now` and returns them in
+    // expiry order. The result is valid until the next call.
+    const std::vector<std::pair<std::uint64_t, Hold>>& expire(std::time_t now);
+};
+
+#endif // AUTHORIZATIONHOLDS_H
@@ -0,0 +1,92 @@
+#include "FaultInjector.h"
+
+SimulatedCrash::SimulatedCrash(FaultPoint faultPoint)
+    : std::runtime_error(std::string("Simulated crash at ") + FaultInjector::pointToString(faultPoint)),
+      point(faultPoint) {}
+
+FaultPoint SimulatedCrash::getPoint() const {
+    return point;
+}
+
+FaultSchedule::FaultSchedule(std::uint64_t scheduleSeed) : seed(scheduleSeed) {}
+
+FaultSchedule& FaultSchedule::setProbability(FaultPoint point, std::uint32_t partsPerMillion) {
+    probabilityPpm[static_cast<int>(point)] = partsPerMillion;
+    return *this;
+}
+
+FaultSchedule& FaultSchedule::failOnHit(FaultPoint point, std::uint64_t hitNumber) {
+    forcedHits.emplace_back(point, hitNumber);
+    return *this;
+}
+
+FaultInjector::FaultInjector(const FaultSchedule& faultSchedule)
+    : schedule(faultSchedule), rng(faultSchedule.seed) {}
+
+bool FaultInjector::shouldFail(FaultPoint point) {
+    const int index = static_cast<int>(point);
+    const std::uint64_t hit = ++hits[index];
+    
+    bool fail = false;
+    for (const auto& forced : schedule.forcedHits) {
+        if (forced.first == point && forced.second == hit) {
+            fail = true;
+        }
+    }
+    
+    // Only points with a probability consume random numbers, so adding a
+    // forced hit elsewhere does not shift the rest of the schedule
+    if (!fail && schedule.probabilityPpm[index] > 0) {
+        fail = (rng() % 1000000) < schedule.probabilityPpm[index];
+    }
+    
+    if (fail) {
+        ++fired[index];
+    }
+    return fail;
+}
+
+void FaultInjector::reset() {
+    rng.seed(schedule.seed);
+    for (int i = 0; i < kPoints; ++i) {
+        hits[i] = 0;
+        fired[i] = 0;
+    }
+}
+
+std::uint64_t FaultInjector::getHits(FaultPoint point) const {
+    return hits[static_cast<int>(point)];
+}
+
+std::uint64_t FaultInjector::getFired(FaultPoint point) const {
+    return fired[static_cast<int>(point)];
+}
+
+std::uint64_t FaultInjector::getTotalFired() const {
+    std::uint64_t total = 0;
+    for (int i = 0; i < kPoints; ++i) {
+        total += fired[i];
+    }
+    return total;
+}
+
+const char* FaultInjector::pointToString(FaultPoint point) {
+    switch (point) {
+        case FaultPoint::TRANSFER_BEFORE_DEBIT:
+            return "TRANSFER_BEFORE_DEBIT";
+        case FaultPoint::TRANSFER_AFTER_DEBIT:
+            return "TRANSFER_AFTER_DEBIT";
+        case FaultPoint::TRANSFER_AFTER_CREDIT:
+            return "TRANSFER_AFTER_CREDIT";
+        case FaultPoint::ROLLBACK_RESTORE_SENDER:
+            return "ROLLBACK_RESTORE_SENDER";
+        case FaultPoint::ROLLBACK_REMOVE_RECIPIENT:
+            return "ROLLBACK_REMOVE_RECIPIENT";
+        case FaultPoint::PERSIST_BEFORE_WRITE:
+            return "PERSIST_BEFORE_WRITE";
+        case FaultPoint::PERSIST_TORN_WRITE:
+            return "PERSIST_TORN_WRITE";
+        default:
+            return "UNKNOWN";
+    }
+}
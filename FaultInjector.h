@@ -0,0 +1,75 @@
+#ifndef FAULTINJECTOR_H
+#define FAULTINJECTOR_H
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// Named points where a failure can be injected
+enum class FaultPoint {
+    TRANSFER_BEFORE_DEBIT,      // Transfer aborts before touching any balance
+    TRANSFER_AFTER_DEBIT,       // Phase 2 fails: sender debited, recipient not credited
+    TRANSFER_AFTER_CREDIT,      // Commit fails after both phases completed
+    ROLLBACK_RESTORE_SENDER,    // Process crashes while restoring the sender
+    ROLLBACK_REMOVE_RECIPIENT,  // Process crashes while reversing the recipient credit
+    PERSIST_BEFORE_WRITE,       // Process crashes before a log record is written
+    PERSIST_TORN_WRITE,         // Process crashes halfway through writing a log record
+    COUNT
+};
+
+// Thrown at crash-type fault points. Models the process dying: in-memory
+// state is no longer trustworthy and must be recovered from the durable log.
+class SimulatedCrash : public std::runtime_error {
+private:
+    FaultPoint point;
+    
+public:
+    explicit SimulatedCrash(FaultPoint faultPoint);
+    FaultPoint getPoint() const;
+};
+
+// Seeded description of when faults fire. Probabilities are per hit, in
+// parts per million; forced hits fire on an exact (1-based) hit number.
+class FaultSchedule {
+private:
+    std::uint64_t seed;
+    std::uint32_t probabilityPpm[static_cast<int>(FaultPoint::COUNT)] = {};
+    std::vector<std::pair<FaultPoint, std::uint64_t>> forcedHits;
+    
+    friend class FaultInjector;
+    
+public:
+    explicit FaultSchedule(std::uint64_t scheduleSeed = 0);
+    
+    FaultSchedule& setProbability(FaultPoint point, std::uint32_t partsPerMillion);
+    FaultSchedule& failOnHit(FaultPoint point, std::uint64_t hitNumber);
+};
+
+// Decides, deterministically for a given schedule, whether each fault point fires
+class FaultInjector {
+private:
+    static constexpr int kPoints = static_cast<int>(FaultPoint::COUNT);
+    
+    FaultSchedule schedule;
+    std::mt19937_64 rng;
+    std::uint64_t hits[kPoints] = {};
+    std::uint64_t fired[kPoints] = {};
+    
+public:
+    explicit FaultInjector(const FaultSchedule& faultSchedule);
+    
+    // Counts a hit on `point` and returns true if the fault fires
+    bool shouldFail(FaultPoint point);
+    
+    // Restarts the schedule from its seed
+    void reset();
+    
+    std::uint64_t getHits(FaultPoint point) const;
+    std::uint64_t getFired(FaultPoint point) const;
+    std::uint64_t getTotalFired() const;
+    
+    static const char* pointToString(FaultPoint point);
+};
+
+#endif // FAULTINJECTOR_H
@@ -1,222 +1,715 @@
 #include "Ledger.h"
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 
-bool Ledger::createAccount(const std::string& accountNumber, const std::string& accountHolder,
-                          long long initialBalanceCents) {
+template <typename Policies>
+Account* BasicLedger<Policies>::findAccount(const std::string& accountNumber) {
+    auto it = accounts.find(accountNumber);
+    if (it != accounts.end()) {
+        return &(it->second);
+    }
+    return nullptr;
+}
+
+template <typename Policies>
+const Account* BasicLedger<Policies>::findAccount(const std::string& accountNumber) const {
+    auto it = accounts.find(accountNumber);
+    if (it != accounts.end()) {
+        return &(it->second);
+    }
+    return nullptr;
+}
+
+template <typename Policies>
+std::vector<Account> BasicLedger<Policies>::snapshotAccounts(const std::vector<const Account*>& matches) {
+    std::vector<Account> snapshot;
+    snapshot.reserve(matches.size());
+    for (const Account* acc : matches) {
+        snapshot.push_back(*acc);
+    }
+    return snapshot;
+}
+
+template <typename Policies>
+bool BasicLedger<Policies>::createAccount(const std::string& accountNumber, const std::string& accountHolder,
+                                          long long initialBalanceCents) {
+    Guard guard(lock);
     if (accounts.find(accountNumber) != accounts.end()) {
+        instrumentation.operationCompleted(LedgerOperation::CREATE_ACCOUNT, false);
         return false;  // Account already exists
     }
     
-    accounts.emplace(accountNumber, Account(accountNumber, accountHolder, initialBalanceCents));
+    auto it = accounts.emplace(accountNumber, Account(accountNumber, accountHolder, initialBalanceCents)).first;
+    index.accountAdded(it->second);
+    const std::time_t openedAt = std::time(nullptr);
+    transactionHistory.accountOpened(accountNumber, initialBalanceCents, openedAt);
+    if (sink.active()) {
+        sink.accountCreated(it->second, openedAt);
+    }
+    instrumentation.operationCompleted(LedgerOperation::CREATE_ACCOUNT, true);
     return true;
 }
 
-bool Ledger::accountExists(const std::string& accountNumber) const {
-    return accounts.find(accountNumber) != accounts.end();
+template <typename Policies>
+void BasicLedger<Policies>::setJournal(LedgerJournal* ledgerJournal) {
+    Guard guard(lock);
+    sink.setJournal(ledgerJournal);
 }
 
-Account* Ledger::getAccount(const std::string& accountNumber) {
-    auto it = accounts.find(accountNumber);
-    if (it != accounts.end()) {
-        return &(it->second);
+template <typename Policies>
+std::uint64_t BasicLedger<Policies>::getJournalSequence() const {
+    Guard guard(lock);
+    return sink.sequence();
+}
+
+template <typename Policies>
+bool BasicLedger<Policies>::waitDurable(std::uint64_t sequence) const {
+    LedgerJournal* journal = nullptr;
+    {
+        Guard guard(lock);
+        journal = sink.getJournal();
     }
-    return nullptr;
+    return journal ? journal->waitDurable(sequence) : true;
 }
 
-const Account* Ledger::getAccount(const std::string& accountNumber) const {
-    auto it = accounts.find(accountNumber);
-    if (it != accounts.end()) {
-        return &(it->second);
+template <typename Policies>
+void BasicLedger<Policies>::recordTransaction(const Transaction& txn) {
+    transactionHistory.append(txn);
+    
+    if (sink.active()) {
+        sink.transactionRecorded(txn, txn.getBalanceAfter());
+    }
+}
+
+template <typename Policies>
+void BasicLedger<Policies>::recordTransaction(const Account& account, long long amountCents,
+                                              TransactionType type, TransactionStatus status,
+                                              const std::string& description,
+                                              const std::string& relatedAccountNumber,
+                                              const std::string& failureReason) {
+    if constexpr (kRecordsTransactions) {
+        Transaction txn(account.getAccountNumber(), amountCents, type, description, relatedAccountNumber);
+        txn.setStatus(status);
+        txn.setBalanceAfter(account.getBalance());
+        txn.setFailureReason(failureReason);
+        recordTransaction(txn);
+    }
+}
+
+template <typename Policies>
+void BasicLedger<Policies>::recordTransfer(const Account& fromAcc, const Account& toAcc, long long amountCents,
+                                           TransactionStatus status, const std::string& description,
+                                           const std::string& failureReason) {
+    if constexpr (kRecordsTransactions) {
+        Transaction debit(fromAcc.getAccountNumber(), amountCents, TransactionType::TRANSFER_OUT, description,
+                          toAcc.getAccountNumber());
+        debit.setStatus(status);
+        debit.setBalanceAfter(fromAcc.getBalance());
+        debit.setFailureReason(failureReason);
+        Transaction credit(toAcc.getAccountNumber(), amountCents, TransactionType::TRANSFER_IN, description,
+                           fromAcc.getAccountNumber());
+        credit.setStatus(status);
+        credit.setBalanceAfter(toAcc.getBalance());
+        credit.setFailureReason(failureReason);
+        
+        transactionHistory.append(debit);
+        transactionHistory.append(credit);
+        if (sink.active()) {
+            sink.transferRecorded(debit, credit);
+        }
     }
-    return nullptr;
 }
 
-bool Ledger::deposit(const std::string& accountNumber, long long amountCents, const std::string& reason) {
-    Account* acc = getAccount(accountNumber);
+template <typename Policies>
+bool BasicLedger<Policies>::replayAccount(const std::string& accountNumber, const std::string& accountHolder,
+                                          long long balanceCents, std::time_t openedAt) {
+    Guard guard(lock);
+    Account* acc = findAccount(accountNumber);
+    if (acc) {
+        long long previousBalance = acc->getBalance();
+        acc->addBalance(balanceCents - previousBalance);
+        index.balanceChanged(*acc, previousBalance);
+        return true;
+    }
+    
+    auto it = accounts.emplace(accountNumber, Account(accountNumber, accountHolder, balanceCents)).first;
+    index.accountAdded(it->second);
+    transactionHistory.accountOpened(accountNumber, balanceCents, openedAt);
+    return true;
+}
+
+template <typename Policies>
+bool BasicLedger<Policies>::replayTransaction(const Transaction& txn, long long balanceAfterCents) {
+    Guard guard(lock);
+    Account* acc = findAccount(txn.getAccountNumber());
+    if (!acc) {
+        return false;
+    }
+    
+    // The primary's post-transaction balance is authoritative, so replicas
+    // converge even for records whose effect is not implied by their type
+    long long previousBalance = acc->getBalance();
+    acc->addBalance(balanceAfterCents - previousBalance);
+    index.balanceChanged(*acc, previousBalance);
+    
+    Transaction entry(txn);
+    entry.setBalanceAfter(balanceAfterCents);
+    transactionHistory.append(entry);
+    return true;
+}
+
+template <typename Policies>
+bool BasicLedger<Policies>::accountExists(const std::string& accountNumber) const {
+    Guard guard(lock);
+    return findAccount(accountNumber) != nullptr;
+}
+
+template <typename Policies>
+std::optional<Account> BasicLedger<Policies>::getAccount(const std::string& accountNumber) const {
+    Guard guard(lock);
+    const Account* acc = findAccount(accountNumber);
+    if (!acc) {
+        return std::nullopt;
+    }
+    return *acc;
+}
+
+template <typename Policies>
+bool BasicLedger<Policies>::deposit(const std::string& accountNumber, long long amountCents,
+                                    const std::string& reason) {
+    Guard guard(lock);
+    Account* acc = findAccount(accountNumber);
     if (!acc || amountCents <= 0) {
+        instrumentation.operationCompleted(LedgerOperation::DEPOSIT, false);
         return false;
     }
     
+    long long previousBalance = acc->getBalance();
     acc->deposit(amountCents);
+    index.balanceChanged(*acc, previousBalance);
     
-    Transaction txn(accountNumber, amountCents, TransactionType::DEPOSIT, reason);
-    txn.setStatus(TransactionStatus::COMPLETED);
-    transactionHistory.push_back(txn);
-    
+    recordTransaction(*acc, amountCents, TransactionType::DEPOSIT, TransactionStatus::COMPLETED, reason);
+    instrumentation.operationCompleted(LedgerOperation::DEPOSIT, true);
     return true;
 }
 
-bool Ledger::withdrawal(const std::string& accountNumber, long long amountCents, const std::string& reason) {
-    Account* acc = getAccount(accountNumber);
+template <typename Policies>
+bool BasicLedger<Policies>::withdrawal(const std::string& accountNumber, long long amountCents,
+                                       const std::string& reason) {
+    Guard guard(lock);
+    expireDueHolds();
+    Account* acc = findAccount(accountNumber);
     if (!acc || amountCents <= 0) {
+        instrumentation.operationCompleted(LedgerOperation::WITHDRAWAL, false);
+        return false;
+    }
+    
+    const std::time_t now = velocity.active() ? std::time(nullptr) : 0;
+    if (!velocity.allows(*acc, VelocityScope::WITHDRAWALS, amountCents, now)) {
+        recordTransaction(*acc, amountCents, TransactionType::WITHDRAWAL, TransactionStatus::FAILED, reason, "",
+                          "Velocity limit exceeded");
+        instrumentation.operationCompleted(LedgerOperation::WITHDRAWAL, false);
         return false;
     }
     
+    long long previousBalance = acc->getBalance();
     if (acc->withdraw(amountCents)) {
-        Transaction txn(accountNumber, amountCents, TransactionType::WITHDRAWAL, reason);
-        txn.setStatus(TransactionStatus::COMPLETED);
-        transactionHistory.push_back(txn);
+        velocity.record(*acc, VelocityScope::WITHDRAWALS, amountCents, now);
+        index.balanceChanged(*acc, previousBalance);
+        recordTransaction(*acc, amountCents, TransactionType::WITHDRAWAL, TransactionStatus::COMPLETED, reason);
+        instrumentation.operationCompleted(LedgerOperation::WITHDRAWAL, true);
         return true;
     }
     
     // Withdrawal failed - log as failed transaction
-    Transaction txn(accountNumber, amountCents, TransactionType::WITHDRAWAL, reason);
-    txn.setStatus(TransactionStatus::FAILED);
-    transactionHistory.push_back(txn);
+    recordTransaction(*acc, amountCents, TransactionType::WITHDRAWAL, TransactionStatus::FAILED, reason);
+    instrumentation.operationCompleted(LedgerOperation::WITHDRAWAL, false);
     return false;
 }
 
-bool Ledger::executeTransfer(const std::string& fromAccNum, const std::string& toAccNum,
-                            long long amountCents) {
-    Account* fromAcc = getAccount(fromAccNum);
-    Account* toAcc = getAccount(toAccNum);
+template <typename Policies>
+typename BasicLedger<Policies>::TransferOutcome
+BasicLedger<Policies>::executeTransfer(const std::string& fromAccNum, const std::string& toAccNum,
+                                       long long amountCents) {
+    Account* fromAcc = findAccount(fromAccNum);
+    Account* toAcc = findAccount(toAccNum);
     
     if (!fromAcc || !toAcc || amountCents <= 0) {
-        return false;
+        return TransferOutcome::REJECTED;
+    }
+    
+    if (faults.shouldFail(FaultPoint::TRANSFER_BEFORE_DEBIT)) {
+        return TransferOutcome::REJECTED;
     }
     
     // Phase 1: Withdraw from sender
     if (!fromAcc->withdraw(amountCents)) {
-        return false;  // Insufficient funds
+        return TransferOutcome::REJECTED;  // Insufficient funds
+    }
+    
+    if (faults.shouldFail(FaultPoint::TRANSFER_AFTER_DEBIT)) {
+        return TransferOutcome::FAILED_AFTER_DEBIT;
     }
     
     // Phase 2: Deposit to recipient
     // In a real system, this could fail (network issues, etc.)
     toAcc->deposit(amountCents);
     
-    return true;
+    if (faults.shouldFail(FaultPoint::TRANSFER_AFTER_CREDIT)) {
+        return TransferOutcome::FAILED_AFTER_CREDIT;
+    }
+    
+    return TransferOutcome::COMMITTED;
 }
 
-void Ledger::rollbackTransfer(const std::string& fromAccNum, const std::string& toAccNum,
-                             long long amountCents) {
-    Account* fromAcc = getAccount(fromAccNum);
-    Account* toAcc = getAccount(toAccNum);
+template <typename Policies>
+void BasicLedger<Policies>::rollbackTransfer(const std::string& fromAccNum, const std::string& toAccNum,
+                                             long long amountCents, TransferOutcome outcome) {
+    Account* fromAcc = findAccount(fromAccNum);
+    Account* toAcc = findAccount(toAccNum);
     
     if (fromAcc && toAcc) {
-        // Reverse the operations
-        fromAcc->addBalance(amountCents);        // Restore to sender
-        toAcc->subtractBalance(amountCents);     // Remove from recipient
-        
-        // Log rollback transactions
-        Transaction rollbackOut(fromAccNum, amountCents, TransactionType::ROLLBACK_DEPOSIT,
-                                "Rollback from failed transfer to " + toAccNum);
-        rollbackOut.setStatus(TransactionStatus::COMPLETED);
-        transactionHistory.push_back(rollbackOut);
+        // Reverse only the phases that completed, newest first
+        if (outcome == TransferOutcome::FAILED_AFTER_CREDIT) {
+            faults.crashIfDue(FaultPoint::ROLLBACK_REMOVE_RECIPIENT);
+            toAcc->subtractBalance(amountCents);     // Remove from recipient
+        }
         
-        Transaction rollbackIn(toAccNum, amountCents, TransactionType::ROLLBACK_WITHDRAWAL,
-                              "Rollback from failed transfer from " + fromAccNum);
-        rollbackIn.setStatus(TransactionStatus::COMPLETED);
-        transactionHistory.push_back(rollbackIn);
+        if (outcome == TransferOutcome::FAILED_AFTER_DEBIT || outcome == TransferOutcome::FAILED_AFTER_CREDIT) {
+            faults.crashIfDue(FaultPoint::ROLLBACK_RESTORE_SENDER);
+            fromAcc->addBalance(amountCents);        // Restore to sender
+        }
     }
 }
 
-bool Ledger::transfer(const std::string& fromAccNum, const std::string& toAccNum,
-                      long long amountCents, const std::string& reason) {
-    if (!accountExists(fromAccNum) || !accountExists(toAccNum)) {
+template <typename Policies>
+bool BasicLedger<Policies>::transferUnlocked(const std::string& fromAccNum, const std::string& toAccNum,
+                                             long long amountCents, const std::string& reason) {
+    expireDueHolds();
+    Account* fromAcc = findAccount(fromAccNum);
+    Account* toAcc = findAccount(toAccNum);
+    if (!fromAcc || !toAcc) {
+        instrumentation.operationCompleted(LedgerOperation::TRANSFER, false);
         return false;
     }
     
-    // Log outgoing transfer
-    Transaction txnOut(fromAccNum, amountCents, TransactionType::TRANSFER_OUT, reason, toAccNum);
-    
-    // Log incoming transfer
-    Transaction txnIn(toAccNum, amountCents, TransactionType::TRANSFER_IN, reason, fromAccNum);
+    const std::time_t now = velocity.active() ? std::time(nullptr) : 0;
+    if (amountCents > 0 && !velocity.allows(*fromAcc, VelocityScope::TRANSFERS, amountCents, now)) {
+        recordTransfer(*fromAcc, *toAcc, amountCents, TransactionStatus::FAILED, reason, "Velocity limit exceeded");
+        instrumentation.operationCompleted(LedgerOperation::TRANSFER, false);
+        return false;
+    }
     
     // Attempt the atomic transfer
-    if (executeTransfer(fromAccNum, toAccNum, amountCents)) {
-        txnOut.setStatus(TransactionStatus::COMPLETED);
-        txnIn.setStatus(TransactionStatus::COMPLETED);
-        transactionHistory.push_back(txnOut);
-        transactionHistory.push_back(txnIn);
+    const long long fromPrevious = fromAcc->getBalance();
+    const long long toPrevious = toAcc->getBalance();
+    TransferOutcome outcome = executeTransfer(fromAccNum, toAccNum, amountCents);
+    if (outcome == TransferOutcome::COMMITTED) {
+        velocity.record(*fromAcc, VelocityScope::TRANSFERS, amountCents, now);
+        index.balanceChanged(*fromAcc, fromPrevious);
+        index.balanceChanged(*toAcc, toPrevious);
+        // Log outgoing and incoming transfer as one record
+        recordTransfer(*fromAcc, *toAcc, amountCents, TransactionStatus::COMPLETED, reason);
+        instrumentation.operationCompleted(LedgerOperation::TRANSFER, true);
         return true;
-    } else {
-        // Transfer failed - mark transactions as failed and perform rollback
-        txnOut.setStatus(TransactionStatus::FAILED);
-        txnIn.setStatus(TransactionStatus::FAILED);
-        transactionHistory.push_back(txnOut);
-        transactionHistory.push_back(txnIn);
-        
-        // Ensure rollback (defensive programming)
-        rollbackTransfer(fromAccNum, toAccNum, amountCents);
-        return false;
-    }
-}
-
-bool Ledger::transferWithFailureSimulation(const std::string& fromAccNum, const std::string& toAccNum,
-                                          long long amountCents, bool failAtPhase2,
-                                          const std::string& reason) {
-    if (!accountExists(fromAccNum) || !accountExists(toAccNum)) {
-        return false;
     }
     
-    std::cout << "\n[SIMULATION] Starting transfer from " << fromAccNum << " to " << toAccNum << std::endl;
+    // Transfer failed - roll back before logging anything, so a crash
+    // mid-rollback never leaves a half-applied transfer in the journal
+    if (outcome != TransferOutcome::REJECTED) {
+        rollbackTransfer(fromAccNum, toAccNum, amountCents, outcome);
+        index.balanceChanged(*fromAcc, fromPrevious);  // No-ops once fully compensated
+        index.balanceChanged(*toAcc, toPrevious);
+    }
     
-    Account* fromAcc = getAccount(fromAccNum);
-    Account* toAcc = getAccount(toAccNum);
+    recordTransfer(*fromAcc, *toAcc, amountCents, TransactionStatus::FAILED, reason);
     
-    // Phase 1: Withdraw
-    std::cout << "[PHASE 1] Withdrawing R" << std::fixed << std::setprecision(2) << (amountCents / 100.0)
-              << " from " << fromAccNum << "..." << std::endl;
+    // Log rollback transactions
+    if (outcome == TransferOutcome::FAILED_AFTER_CREDIT) {
+        recordTransaction(*toAcc, amountCents, TransactionType::ROLLBACK_WITHDRAWAL, TransactionStatus::COMPLETED,
+                          "Rollback from failed transfer from " + fromAccNum);
+    }
+    if (outcome != TransferOutcome::REJECTED) {
+        recordTransaction(*fromAcc, amountCents, TransactionType::ROLLBACK_DEPOSIT, TransactionStatus::COMPLETED,
+                          "Rollback from failed transfer to " + toAccNum);
+    }
     
-    if (!fromAcc->withdraw(amountCents)) {
-        std::cout << "[ERROR] Insufficient funds! Rollback not needed." << std::endl;
+    instrumentation.operationCompleted(LedgerOperation::TRANSFER, false);
+    return false;
+}
+
+template <typename Policies>
+bool BasicLedger<Policies>::transfer(const std::string& fromAccNum, const std::string& toAccNum,
+                                     long long amountCents, const std::string& reason) {
+    Guard guard(lock);
+    return transferUnlocked(fromAccNum, toAccNum, amountCents, reason);
+}
+
+template <typename Policies>
+void BasicLedger<Policies>::recordHoldTransaction(const Account& account, std::uint64_t holdId,
+                                                  long long amountCents, TransactionType type,
+                                                  TransactionStatus status, const std::string& note) {
+    if constexpr (kRecordsTransactions) {
+        recordTransaction(account, amountCents, type, status,
+                          "Hold " + std::to_string(holdId) + (note.empty() ? "" : ": " + note));
+    }
+}
+
+template <typename Policies>
+void BasicLedger<Policies>::expireDueHolds() {
+    if constexpr (HoldPolicy::kEnabled) {
+        if (!holds.empty()) {
+            expireHoldsUnlocked(std::time(nullptr));
+        }
+    }
+}
+
+template <typename Policies>
+std::size_t BasicLedger<Policies>::expireHoldsUnlocked(std::time_t now) {
+    const auto& expired = holds.expire(now);
+    for (const auto& entry : expired) {
+        const AuthorizationHolds::Hold& hold = entry.second;
+        hold.account->releaseHeld(hold.amountCents);
+        recordHoldTransaction(*hold.account, entry.first, hold.amountCents, TransactionType::HOLD_EXPIRY,
+                              TransactionStatus::COMPLETED, "expired");
+    }
+    return expired.size();
+}
+
+template <typename Policies>
+bool BasicLedger<Policies>::placeHold(const std::string& accountNumber, long long amountCents,
+                                      std::time_t expiresAt, std::uint64_t& holdId, const std::string& reason) {
+    Guard guard(lock);
+    expireDueHolds();
+    Account* acc = findAccount(accountNumber);
+    if (!HoldPolicy::kEnabled || !acc || amountCents <= 0) {
+        instrumentation.operationCompleted(LedgerOperation::PLACE_HOLD, false);
         return false;
     }
-    std::cout << "[SUCCESS] Phase 1 complete." << std::endl;
     
-    // Simulate system failure at Phase 2
-    if (failAtPhase2) {
-        std::cout << "[CRITICAL] System crash detected during Phase 2!" << std::endl;
-        std::cout << "[ROLLBACK] Initiating automatic rollback..." << std::endl;
-        
-        // Rollback Phase 1
-        fromAcc->addBalance(amountCents);
-        std::cout << "[SUCCESS] Funds restored to " << fromAccNum << std::endl;
-        
-        Transaction txn(fromAccNum, amountCents, TransactionType::ROLLBACK_DEPOSIT,
-                        "Automatic rollback due to system failure");
-        txn.setStatus(TransactionStatus::COMPLETED);
-        transactionHistory.push_back(txn);
-        
+    // A declined hold never gets an ID
+    if (!acc->hold(amountCents)) {
+        recordTransaction(*acc, amountCents, TransactionType::AUTHORIZATION_HOLD, TransactionStatus::FAILED,
+                          reason, "", "Hold declined");
+        instrumentation.operationCompleted(LedgerOperation::PLACE_HOLD, false);
         return false;
     }
     
-    // Phase 2: Deposit
-    std::cout << "[PHASE 2] Depositing R" << std::fixed << std::setprecision(2) << (amountCents / 100.0)
-              << " to " << toAccNum << "..." << std::endl;
-    toAcc->deposit(amountCents);
-    std::cout << "[SUCCESS] Phase 2 complete. Transfer successful!" << std::endl;
+    holdId = holds.open(*acc, amountCents, expiresAt);
+    recordHoldTransaction(*acc, holdId, amountCents, TransactionType::AUTHORIZATION_HOLD,
+                          TransactionStatus::PENDING, reason);
+    instrumentation.operationCompleted(LedgerOperation::PLACE_HOLD, true);
+    return true;
+}
+
+template <typename Policies>
+bool BasicLedger<Policies>::captureHold(std::uint64_t holdId, long long amountCents, const std::string& reason) {
+    Guard guard(lock);
+    expireDueHolds();
+    const AuthorizationHolds::Hold* open = holds.find(holdId);
+    if (!open || amountCents <= 0 || amountCents > open->amountCents) {
+        instrumentation.operationCompleted(LedgerOperation::CAPTURE_HOLD, false);
+        return false;  // Unknown, already settled, expired, or over the authorized amount
+    }
     
-    // Log transactions
-    Transaction txnOut(fromAccNum, amountCents, TransactionType::TRANSFER_OUT, reason, toAccNum);
-    txnOut.setStatus(TransactionStatus::COMPLETED);
-    transactionHistory.push_back(txnOut);
+    AuthorizationHolds::Hold hold;
+    holds.close(holdId, hold);
+    long long previousBalance = hold.account->getBalance();
+    hold.account->releaseHeld(hold.amountCents);
+    hold.account->subtractBalance(amountCents);
+    index.balanceChanged(*hold.account, previousBalance);
     
-    Transaction txnIn(toAccNum, amountCents, TransactionType::TRANSFER_IN, reason, fromAccNum);
-    txnIn.setStatus(TransactionStatus::COMPLETED);
-    transactionHistory.push_back(txnIn);
+    recordHoldTransaction(*hold.account, holdId, amountCents, TransactionType::HOLD_CAPTURE,
+                          TransactionStatus::COMPLETED, reason);
+    instrumentation.operationCompleted(LedgerOperation::CAPTURE_HOLD, true);
+    return true;
+}
+
+template <typename Policies>
+bool BasicLedger<Policies>::releaseHold(std::uint64_t holdId, const std::string& reason) {
+    Guard guard(lock);
+    expireDueHolds();
+    AuthorizationHolds::Hold hold;
+    if (!holds.close(holdId, hold)) {
+        instrumentation.operationCompleted(LedgerOperation::RELEASE_HOLD, false);
+        return false;
+    }
     
+    hold.account->releaseHeld(hold.amountCents);
+    recordHoldTransaction(*hold.account, holdId, hold.amountCents, TransactionType::HOLD_RELEASE,
+                          TransactionStatus::COMPLETED, reason);
+    instrumentation.operationCompleted(LedgerOperation::RELEASE_HOLD, true);
     return true;
 }
 
-std::vector<Transaction> Ledger::getTransactionHistory() const {
-    return transactionHistory;
+template <typename Policies>
+std::size_t BasicLedger<Policies>::processExpiredHolds(std::time_t now) {
+    Guard guard(lock);
+    return expireHoldsUnlocked(now);
+}
+
+template <typename Policies>
+std::size_t BasicLedger<Policies>::getOpenHoldCount() const {
+    Guard guard(lock);
+    return holds.size();
+}
+
+template <typename Policies>
+std::vector<Account> BasicLedger<Policies>::findAccountsByHolder(const std::string& holderPrefix,
+                                                                 std::size_t limit) const {
+    Guard guard(lock);
+    return snapshotAccounts(index.findByHolderPrefix(holderPrefix, limit));
+}
+
+template <typename Policies>
+std::vector<Account> BasicLedger<Policies>::getLargestBalances(std::size_t count) const {
+    Guard guard(lock);
+    return snapshotAccounts(index.largestBalances(count));
+}
+
+template <typename Policies>
+std::vector<Account> BasicLedger<Policies>::getAccountsInBalanceRange(long long minCents, long long maxCents,
+                                                                      std::size_t limit) const {
+    Guard guard(lock);
+    return snapshotAccounts(index.balancesInRange(minCents, maxCents, limit));
 }
 
-std::vector<Transaction> Ledger::getAccountTransactions(const std::string& accountNumber) const {
-    std::vector<Transaction> accountTxns;
+template <typename Policies>
+AccrualSummary BasicLedger<Policies>::postAccruals(const RateSchedule& schedule, unsigned threads) {
+    // Interest divides by the year length
+    if (schedule.daysInYear <= 0) {
+        std::cerr << "Error: accrual schedule has " << schedule.daysInYear
+                  << " days in a year; nothing posted." << std::endl;
+        return AccrualSummary{};
+    }
+    
+    Guard guard(lock);
+    AccrualEngine engine(schedule);
     
-    for (const auto& txn : transactionHistory) {
-        if (txn.getAccountNumber() == accountNumber) {
-            accountTxns.push_back(txn);
+    // Random-access snapshot so the accounts can be split into ranges
+    std::vector<Account*> accountList;
+    accountList.reserve(accounts.size());
+    for (auto& pair : accounts) {
+        accountList.push_back(&pair.second);
+    }
+    
+    const std::size_t count = accountList.size();
+    const std::size_t ranges = AccrualEngine::rangesFor(count, threads);
+    std::vector<long long> interest(count);
+    std::vector<long long> fees(count);
+    std::vector<AccrualSummary> partial(ranges);
+    
+    // Pass 1: compute every posting from the opening balances
+    AccrualEngine::parallelFor(count, threads, [&](std::size_t begin, std::size_t end, std::size_t range) {
+        AccrualSummary& summary = partial[range];
+        for (std::size_t i = begin; i < end; ++i) {
+            long long balance = accountList[i]->getBalance();
+            interest[i] = engine.interestFor(balance);
+            fees[i] = engine.feeFor(balance + interest[i]);
+            long long available = accountList[i]->getAvailableBalance() + interest[i];
+            
+            ++summary.accountsProcessed;
+            if (interest[i] > 0) {
+                ++summary.interestPostings;
+                summary.totalInterestCents += interest[i];
+            }
+            if (fees[i] > 0) {
+                if (available >= fees[i]) {
+                    ++summary.feePostings;
+                    summary.totalFeesCents += fees[i];
+                } else {
+                    ++summary.failedFees;
+                }
+            }
+        }
+    });
+    
+    // Reserve a contiguous block of transaction IDs per range
+    std::vector<long long> firstSequence(ranges);
+    if constexpr (kRecordsTransactions) {
+        long long postings = 0;
+        for (const auto& summary : partial) {
+            postings += summary.interestPostings + summary.feePostings + summary.failedFees;
+        }
+        long long next = Transaction::reserveSequenceNumbers(postings);
+        for (std::size_t r = 0; r < ranges; ++r) {
+            firstSequence[r] = next;
+            next += partial[r].interestPostings + partial[r].feePostings + partial[r].failedFees;
         }
     }
     
-    return accountTxns;
+    // Pass 2: apply balances and build the transactions, still in parallel.
+    // Each range also sorts its accounts' new balance keys, so the balance
+    // index can be rebuilt in one pass instead of re-keying every account.
+    const std::time_t now = std::time(nullptr);
+    const std::string interestNote = "Interest accrual";
+    const std::string feeNote = "Monthly account fee";
+    std::vector<std::vector<Transaction>> postings(ranges);
+    std::vector<std::pair<long long, const Account*>> balanceKeys(IndexPolicy::kEnabled ? count : 0);
+    AccrualEngine::parallelFor(count, threads, [&](std::size_t begin, std::size_t end, std::size_t range) {
+        long long sequence = firstSequence[range];
+        std::vector<Transaction>& out = postings[range];
+        if constexpr (kRecordsTransactions) {
+            out.reserve(partial[range].interestPostings + partial[range].feePostings + partial[range].failedFees);
+        }
+        
+        for (std::size_t i = begin; i < end; ++i) {
+            Account* acc = accountList[i];
+            if (interest[i] > 0) {
+                acc->addBalance(interest[i]);
+                if constexpr (kRecordsTransactions) {
+                    out.emplace_back(Transaction::makeTransactionId(sequence++, now), acc->getAccountNumber(),
+                                     interest[i], TransactionType::INTEREST_CREDIT, TransactionStatus::COMPLETED,
+                                     now, interestNote);
+                    out.back().setBalanceAfter(acc->getBalance());
+                }
+            }
+            if (fees[i] > 0) {
+                bool charged = acc->getAvailableBalance() >= fees[i];
+                if (charged) {
+                    acc->subtractBalance(fees[i]);
+                }
+                if constexpr (kRecordsTransactions) {
+                    out.emplace_back(Transaction::makeTransactionId(sequence++, now), acc->getAccountNumber(),
+                                     fees[i], TransactionType::FEE_DEBIT,
+                                     charged ? TransactionStatus::COMPLETED : TransactionStatus::FAILED,
+                                     now, feeNote);
+                    out.back().setBalanceAfter(acc->getBalance());
+                }
+            }
+            if constexpr (IndexPolicy::kEnabled) {
+                balanceKeys[i] = std::make_pair(acc->getBalance(), acc);
+            }
+        }
+        if constexpr (IndexPolicy::kEnabled) {
+            std::sort(balanceKeys.begin() + begin, balanceKeys.begin() + end);
+        }
+    });
+    
+    // Merge the sorted ranges pairwise (they are parallelFor's equal chunks)
+    // and rebuild the balance index from the result
+    if constexpr (IndexPolicy::kEnabled) {
+        const std::size_t chunk = (count + ranges - 1) / ranges;
+        for (std::size_t width = chunk; width > 0 && width < count; width *= 2) {
+            for (std::size_t begin = 0; begin + width < count; begin += 2 * width) {
+                std::inplace_merge(balanceKeys.begin() + begin, balanceKeys.begin() + begin + width,
+                                   balanceKeys.begin() + std::min(count, begin + 2 * width));
+            }
+        }
+        index.rebuildBalances(balanceKeys);
+    }
+    
+    // Bulk append, in account order; each range's postings are linked into
+    // the timeline on its own thread, since ranges share no accounts
+    if (sink.active()) {
+        for (const auto& range : postings) {
+            for (const auto& txn : range) {
+                sink.transactionRecorded(txn, txn.getBalanceAfter());
+            }
+        }
+    }
+    transactionHistory.appendBatches(std::move(postings), threads);
+    
+    AccrualSummary summary;
+    for (std::size_t r = 0; r < ranges; ++r) {
+        summary.accountsProcessed += partial[r].accountsProcessed;
+        summary.interestPostings += partial[r].interestPostings;
+        summary.feePostings += partial[r].feePostings;
+        summary.failedFees += partial[r].failedFees;
+        summary.totalInterestCents += partial[r].totalInterestCents;
+        summary.totalFeesCents += partial[r].totalFeesCents;
+    }
+    
+    return summary;
 }
 
-void Ledger::displayAllAccounts() const {
+template <typename Policies>
+bool BasicLedger<Policies>::transferWithFailureSimulation(const std::string& fromAccNum, const std::string& toAccNum,
+                                                          long long amountCents, bool failAtPhase2,
+                                                          const std::string& reason) {
+    Guard guard(lock);
+    if (!findAccount(fromAccNum) || !findAccount(toAccNum)) {
+        return false;
+    }
+    
+    std::cout << "\n[SIMULATION] Starting transfer of R" << std::fixed << std::setprecision(2)
+              << (amountCents / 100.0) << " from " << fromAccNum << " to " << toAccNum << std::endl;
+    
+    // Drive the regular transfer path with a one-shot Phase 2 fault
+    FaultInjector phase2Failure(FaultSchedule().failOnHit(FaultPoint::TRANSFER_AFTER_DEBIT, 1));
+    FaultInjector* previousInjector = faults.getInjector();
+    if (failAtPhase2) {
+        faults.setInjector(&phase2Failure);
+    }
+    
+    bool committed = transferUnlocked(fromAccNum, toAccNum, amountCents, reason);
+    faults.setInjector(previousInjector);
+    
+    if (committed) {
+        std::cout << "[SUCCESS] Phase 1 and Phase 2 complete. Transfer successful!" << std::endl;
+    } else if (phase2Failure.getFired(FaultPoint::TRANSFER_AFTER_DEBIT) > 0) {
+        std::cout << "[SUCCESS] Phase 1 complete." << std::endl;
+        std::cout << "[CRITICAL] System failure injected during Phase 2!" << std::endl;
+        std::cout << "[ROLLBACK] Automatic rollback restored funds to " << fromAccNum << std::endl;
+    } else {
+        // The FAILED debit leg is the newest transfer-out entry
+        std::string failureReason;
+        const std::vector<Transaction>& history = transactionHistory.all();
+        for (auto it = history.rbegin(); it != history.rend(); ++it) {
+            if (it->getType() == TransactionType::TRANSFER_OUT) {
+                if (it->getStatus() == TransactionStatus::FAILED) {
+                    failureReason = it->getFailureReason();
+                }
+                break;
+            }
+        }
+        std::cout << "[ERROR] Transfer rejected" << (failureReason.empty() ? "" : ": " + failureReason)
+                  << ". Rollback not needed." << std::endl;
+    }
+    
+    return committed;
+}
+
+template <typename Policies>
+void BasicLedger<Policies>::setVelocityLimits(const std::vector<VelocityRule>& rules) {
+    Guard guard(lock);
+    velocity.setRules(rules);
+}
+
+template <typename Policies>
+void BasicLedger<Policies>::setFaultInjector(FaultInjector* injector) {
+    Guard guard(lock);
+    faults.setInjector(injector);
+}
+
+template <typename Policies>
+std::vector<Transaction> BasicLedger<Policies>::getTransactionHistory() const {
+    Guard guard(lock);
+    return transactionHistory.all();
+}
+
+template <typename Policies>
+std::vector<Transaction> BasicLedger<Policies>::getAccountTransactions(const std::string& accountNumber) const {
+    Guard guard(lock);
+    return transactionHistory.forAccount(accountNumber);
+}
+
+template <typename Policies>
+bool BasicLedger<Policies>::balanceAt(const std::string& accountNumber, std::time_t timestamp,
+                                      long long& balanceCents) const {
+    Guard guard(lock);
+    return transactionHistory.balanceAt(accountNumber, timestamp, balanceCents);
+}
+
+template <typename Policies>
+const typename Policies::InstrumentationPolicy& BasicLedger<Policies>::getInstrumentation() const {
+    return instrumentation;
+}
+
+template <typename Policies>
+void BasicLedger<Policies>::displayAllAccounts() const {
+    Guard guard(lock);
     std::cout << "\n" << std::string(80, '=') << std::endl;
     std::cout << "ALL ACCOUNTS" << std::endl;
     std::cout << std::string(80, '=') << std::endl;
@@ -242,8 +735,10 @@ void Ledger::displayAllAccounts() const {
     std::cout << std::string(80, '=') << std::endl;
 }
 
-void Ledger::displayAccountStatement(const std::string& accountNumber) const {
-    const Account* acc = getAccount(accountNumber);
+template <typename Policies>
+void BasicLedger<Policies>::displayAccountStatement(const std::string& accountNumber) const {
+    Guard guard(lock);
+    const Account* acc = findAccount(accountNumber);
     if (!acc) {
         std::cout << "Account not found." << std::endl;
         return;
@@ -253,34 +748,46 @@ void Ledger::displayAccountStatement(const std::string& accountNumber) const {
     std::cout << "ACCOUNT STATEMENT: " << accountNumber << std::endl;
     std::cout << "Holder: " << acc->getAccountHolder() << std::endl;
     std::cout << "Current Balance: R" << std::fixed << std::setprecision(2) << (acc->getBalance() / 100.0) << std::endl;
+    if (acc->getHeldBalance() > 0) {
+        std::cout << "Available Balance: R" << (acc->getAvailableBalance() / 100.0)
+                  << " (R" << (acc->getHeldBalance() / 100.0) << " on hold)" << std::endl;
+    }
     std::cout << std::string(100, '=') << std::endl;
     
-    auto txns = getAccountTransactions(accountNumber);
-    if (txns.empty()) {
-        std::cout << "No transactions found." << std::endl;
-        return;
+    std::vector<Transaction> accountTxns = transactionHistory.forAccount(accountNumber);
+    for (const auto& txn : accountTxns) {
+        std::cout << txn.getFormattedString() << std::endl;
     }
     
-    for (const auto& txn : txns) {
-        std::cout << txn.getFormattedString() << std::endl;
+    if (accountTxns.empty()) {
+        std::cout << "No transactions found." << std::endl;
+        return;
     }
     
     std::cout << std::string(100, '=') << std::endl;
 }
 
-void Ledger::displayTransactionHistory() const {
+template <typename Policies>
+void BasicLedger<Policies>::displayTransactionHistory() const {
+    Guard guard(lock);
     std::cout << "\n" << std::string(100, '=') << std::endl;
     std::cout << "COMPLETE TRANSACTION HISTORY" << std::endl;
     std::cout << std::string(100, '=') << std::endl;
     
-    if (transactionHistory.empty()) {
+    if (transactionHistory.all().empty()) {
         std::cout << "No transactions found." << std::endl;
         return;
     }
     
-    for (const auto& txn : transactionHistory) {
+    for (const auto& txn : transactionHistory.all()) {
         std::cout << txn.getFormattedString() << std::endl;
     }
     
     std::cout << std::string(100, '=') << std::endl;
 }
+
+// Explicit instantiations for the supported configurations
+template class BasicLedger<DefaultLedgerPolicies>;
+template class BasicLedger<BatchLedgerPolicies>;
+template class BasicLedger<ConcurrentLedgerPolicies>;
+template class BasicLedger<FaultHarnessLedgerPolicies>;
@@ -2,29 +2,95 @@
 #define LEDGER_H
 
 #include "Account.h"
+#include "AccrualEngine.h"
 #include "Transaction.h"
+#include "LedgerJournal.h"
+#include "LedgerPolicies.h"
+#include <cstdint>
+#include <ctime>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <memory>
+#include <optional>
 
-class Ledger {
+// Core ledger, configured at compile time through a LedgerPolicies bundle
+// (locking, history storage, persistence sink, instrumentation, faults,
+// secondary indexes, authorization holds, velocity limits).
+// See the Ledger / BatchLedger / ConcurrentLedger aliases below.
+template <typename Policies>
+class BasicLedger {
 private:
+    using LockPolicy = typename Policies::LockPolicy;
+    using HistoryPolicy = typename Policies::HistoryPolicy;
+    using SinkPolicy = typename Policies::SinkPolicy;
+    using InstrumentationPolicy = typename Policies::InstrumentationPolicy;
+    using FaultPolicy = typename Policies::FaultPolicy;
+    using IndexPolicy = typename Policies::IndexPolicy;
+    using HoldPolicy = typename Policies::HoldPolicy;
+    using VelocityPolicy = typename Policies::VelocityPolicy;
+    using Guard = typename LockPolicy::Guard;
+    
+    // Transactions are only built when something will consume them
+    static constexpr bool kRecordsTransactions = HistoryPolicy::kEnabled || SinkPolicy::kEnabled;
+    
     std::map<std::string, Account> accounts;
-    std::vector<Transaction> transactionHistory;
+    HistoryPolicy transactionHistory;
+    SinkPolicy sink;
+    InstrumentationPolicy instrumentation;
+    FaultPolicy faults;
+    IndexPolicy index;
+    HoldPolicy holds;
+    VelocityPolicy velocity;
+    mutable LockPolicy lock;
+    
+    // Unlocked lookups for use while the lock is held
+    Account* findAccount(const std::string& accountNumber);
+    const Account* findAccount(const std::string& accountNumber) const;
+    static std::vector<Account> snapshotAccounts(const std::vector<const Account*>& matches);
+    
+    // Appends to the history and forwards the record to the sink.
+    // `failureReason` says why the ledger rejected a FAILED entry; the
+    // caller's description is kept as it was given.
+    void recordTransaction(const Transaction& txn);
+    void recordTransaction(const Account& account, long long amountCents, TransactionType type,
+                           TransactionStatus status, const std::string& description = "",
+                           const std::string& relatedAccountNumber = "", const std::string& failureReason = "");
+    
+    // Records both legs of a transfer as one journal entry
+    void recordTransfer(const Account& fromAcc, const Account& toAcc, long long amountCents,
+                        TransactionStatus status, const std::string& description,
+                        const std::string& failureReason = "");
+    
+    // How far a transfer got before it stopped
+    enum class TransferOutcome {
+        COMMITTED,
+        REJECTED,             // Nothing was changed
+        FAILED_AFTER_DEBIT,   // Sender debited, recipient not credited
+        FAILED_AFTER_CREDIT   // Both phases applied, commit failed
+    };
     
     // Helper methods for rollback
-    bool executeTransfer(const std::string& fromAccNum, const std::string& toAccNum,
-                        long long amountCents);
+    TransferOutcome executeTransfer(const std::string& fromAccNum, const std::string& toAccNum,
+                                    long long amountCents);
     void rollbackTransfer(const std::string& fromAccNum, const std::string& toAccNum,
-                         long long amountCents);
+                         long long amountCents, TransferOutcome outcome);
+    bool transferUnlocked(const std::string& fromAccNum, const std::string& toAccNum,
+                          long long amountCents, const std::string& reason);
+    
+    // Helpers for authorization holds (lock held)
+    std::size_t expireHoldsUnlocked(std::time_t now);
+    void expireDueHolds();  // Cheap no-op while no holds are open
+    void recordHoldTransaction(const Account& account, std::uint64_t holdId, long long amountCents,
+                               TransactionType type, TransactionStatus status, const std::string& note);
     
 public:
     // Account management
     bool createAccount(const std::string& accountNumber, const std::string& accountHolder,
                        long long initialBalanceCents = 0);
     bool accountExists(const std::string& accountNumber) const;
-    Account* getAccount(const std::string& accountNumber);
-    const Account* getAccount(const std::string& accountNumber) const;
+    // A copy taken under the lock; empty if the account does not exist
+    std::optional<Account> getAccount(const std::string& accountNumber) const;
     
     // Transaction operations with ACID properties
     bool deposit(const std::string& accountNumber, long long amountCents, const std::string& reason = "");
@@ -34,19 +100,101 @@ public:
     bool transfer(const std::string& fromAccNum, const std::string& toAccNum,
                   long long amountCents, const std::string& reason = "");
     
-    // Simulates a system failure during transfer (for testing rollback)
+    // Card-style authorization holds. A hold reserves funds against the
+    // available balance (balance minus open holds) until it is captured,
+    // released, or reaches `expiresAt`. The placement is recorded PENDING;
+    // `holdId` is only assigned when it succeeds. Always fail with NoHolds.
+    bool placeHold(const std::string& accountNumber, long long amountCents, std::time_t expiresAt,
+                   std::uint64_t& holdId, const std::string& reason = "");
+    bool captureHold(std::uint64_t holdId, long long amountCents,
+                     const std::string& reason = "");  // Any uncaptured remainder is released
+    bool releaseHold(std::uint64_t holdId, const std::string& reason = "");
+    
+    // Expires every hold due at or before `now`; returns how many expired.
+    // Also runs before each withdrawal, transfer and hold operation.
+    std::size_t processExpiredHolds(std::time_t now);
+    std::size_t getOpenHoldCount() const;
+    
+    // Sliding-window limits on each account's withdrawals and outgoing
+    // transfers (e.g. daily and hourly caps). A debit that would break a
+    // rule is recorded FAILED with the failure reason "Velocity limit
+    // exceeded" and the caller's description. Setting new rules resets all
+    // counters. Ignored with NoVelocityLimits (BatchLedger).
+    void setVelocityLimits(const std::vector<VelocityRule>& rules);
+    
+    // Secondary index queries; empty with NoIndex (BatchLedger).
+    // Results are snapshots, so they stay valid after the lock is released.
+    std::vector<Account> findAccountsByHolder(const std::string& holderPrefix, std::size_t limit = 50) const;
+    std::vector<Account> getLargestBalances(std::size_t count) const;
+    std::vector<Account> getAccountsInBalanceRange(long long minCents, long long maxCents,
+                                                   std::size_t limit = 100) const;
+    
+    // End-of-day batch: posts interest (and, if scheduled, monthly fees) to
+    // every account in parallel over account ranges, then appends all the
+    // resulting transactions in bulk and rebuilds the balance index in one
+    // pass. `threads` = 0 uses every core. A schedule with `daysInYear` <= 0
+    // posts nothing and returns an empty summary.
+    AccrualSummary postAccruals(const RateSchedule& schedule, unsigned threads = 0);
+    
+    // Simulates a system failure during transfer (for testing rollback).
+    // Injects a one-shot TRANSFER_AFTER_DEBIT fault; has no effect with NoFaults.
     bool transferWithFailureSimulation(const std::string& fromAccNum, const std::string& toAccNum,
                                        long long amountCents, bool failAtPhase2 = false,
                                        const std::string& reason = "");
     
+    // Fault injection: consulted at every FaultPoint in transfers and rollbacks
+    void setFaultInjector(FaultInjector* injector);
+    
+    // Replication: every account creation and history record is forwarded to the journal
+    void setJournal(LedgerJournal* ledgerJournal);
+    
+    // Journal sequence number of the last change made so far (0 without a journal)
+    std::uint64_t getJournalSequence() const;
+    
+    // Blocks until the journal has made every change up to `sequence`
+    // durable. Takes the ledger lock only to read the attached journal, not
+    // while waiting, so other operations proceed meanwhile; concurrent
+    // waiters share the journal's disk syncs.
+    bool waitDurable(std::uint64_t sequence) const;
+    
+    // Applies a record received from a primary's journal (replica side).
+    // `openedAt` is the primary's creation time, used by balanceAt().
+    bool replayAccount(const std::string& accountNumber, const std::string& accountHolder,
+                       long long balanceCents, std::time_t openedAt);
+    bool replayTransaction(const Transaction& txn, long long balanceAfterCents);
+    
     // Getters
     std::vector<Transaction> getTransactionHistory() const;
     std::vector<Transaction> getAccountTransactions(const std::string& accountNumber) const;
     
+    // Balance as of `timestamp` (inclusive), from the running balance on each
+    // history entry: a checkpoint binary search plus a short replay.
+    // Returns false if the account did not exist then, or with NoHistory.
+    bool balanceAt(const std::string& accountNumber, std::time_t timestamp, long long& balanceCents) const;
+    const InstrumentationPolicy& getInstrumentation() const;
+    
     // Display methods
     void displayAllAccounts() const;
     void displayAccountStatement(const std::string& accountNumber) const;
     void displayTransactionHistory() const;
 };
 
+// Today's behaviour: single-threaded, full history, optional journal
+using Ledger = BasicLedger<DefaultLedgerPolicies>;
+
+// Batch replays: pure balance updates with no history, locks or hooks
+using BatchLedger = BasicLedger<BatchLedgerPolicies>;
+
+// Multi-threaded online service
+using ConcurrentLedger = BasicLedger<ConcurrentLedgerPolicies>;
+
+// Ledger whose crash points throw SimulatedCrash (fault_harness only)
+using FaultHarnessLedger = BasicLedger<FaultHarnessLedgerPolicies>;
+
+// Instantiated in Ledger.cpp
+extern template class BasicLedger<DefaultLedgerPolicies>;
+extern template class BasicLedger<BatchLedgerPolicies>;
+extern template class BasicLedger<ConcurrentLedgerPolicies>;
+extern template class BasicLedger<FaultHarnessLedgerPolicies>;
+
 #endif // LEDGER_H
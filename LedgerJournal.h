@@ -0,0 +1,34 @@
+#ifndef LEDGERJOURNAL_H
+#define LEDGERJOURNAL_H
+
+#include "Account.h"
+#include "Transaction.h"
+#include <cstdint>
+#include <ctime>
+
+// Receives every state change made by a Ledger, in order.
+// Used to ship the ledger's history to replicas and durable logs.
+class LedgerJournal {
+public:
+    virtual ~LedgerJournal() = default;
+
+    // `openedAt` is the primary's creation time, so replicas date the account the same way
+    virtual void accountCreated(const Account& account, std::time_t openedAt) = 0;
+
+    // `balanceAfterCents` is the account balance once `txn` has been applied
+    virtual void transactionRecorded(const Transaction& txn, long long balanceAfterCents) = 0;
+
+    // Both legs of a transfer. Must be persisted as one unit: recovery may
+    // see both legs or neither, never only the debit.
+    virtual void transferRecorded(const Transaction& debit, long long debitBalanceAfterCents,
+                                  const Transaction& credit, long long creditBalanceAfterCents) = 0;
+
+    // Sequence number of the last change received (1, 2, ...)
+    virtual std::uint64_t getSequence() const = 0;
+
+    // Blocks until every change up to `sequence` is on stable storage.
+    // Journals that write synchronously are always durable.
+    virtual bool waitDurable(std::uint64_t /* sequence */) { return true; }
+};
+
+#endif // LEDGERJOURNAL_H
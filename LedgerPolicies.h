@@ -0,0 +1,305 @@
+#ifndef LEDGERPOLICIES_H
+#define LEDGERPOLICIES_H
+
+#include "Account.h"
+#include "AccountIndex.h"
+#include "AccountTimeline.h"
+#include "AccrualEngine.h"
+#include "AuthorizationHolds.h"
+#include "FaultInjector.h"
+#include "LedgerJournal.h"
+#include "Transaction.h"
+#include "VelocityLimiter.h"
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+// Compile-time policies for BasicLedger. Each concern has a no-op
+// implementation that compiles away entirely, so a ledger only pays for
+// the features its policies enable.
+
+// ==================== Locking ====================
+
+struct NoLocking {
+    struct Guard {
+        explicit Guard(NoLocking&) {}
+    };
+};
+
+class MutexLocking {
+private:
+    std::mutex mutex;
+    
+public:
+    class Guard {
+    private:
+        std::lock_guard<std::mutex> lock;
+        
+    public:
+        explicit Guard(MutexLocking& policy) : lock(policy.mutex) {}
+    };
+};
+
+// ==================== History storage ====================
+
+// Full history plus per-account links and balance checkpoints
+class VectorHistory {
+private:
+    std::vector<Transaction> entries;
+    AccountTimeline timeline;
+    
+public:
+    static constexpr bool kEnabled = true;
+    
+    void accountOpened(const std::string& accountNumber, long long openingBalanceCents, std::time_t openedAt) {
+        timeline.accountOpened(accountNumber, openingBalanceCents, openedAt);
+    }
+    void append(const Transaction& txn) {
+        entries.push_back(txn);
+        timeline.entryAppended(entries.back(), entries.size() - 1);
+    }
+    // Appends the batches in order and links them into the timeline, one
+    // thread per batch. Batches must not share accounts.
+    void appendBatches(std::vector<std::vector<Transaction>>&& batches, unsigned threads) {
+        std::vector<std::size_t> firstEntry(batches.size() + 1, entries.size());
+        std::size_t total = entries.size();
+        for (std::size_t b = 0; b < batches.size(); ++b) {
+            total += batches[b].size();
+            firstEntry[b + 1] = total;
+        }
+        if (total > entries.capacity()) {
+            entries.reserve(std::max(total, 2 * entries.capacity()));  // Keep growth geometric
+        }
+        for (auto& batch : batches) {
+            entries.insert(entries.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+        }
+        
+        timeline.reserveEntries(total);
+        AccrualEngine::parallelFor(batches.size(), threads, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t b = begin; b < end; ++b) {
+                timeline.linkEntries(entries, firstEntry[b], firstEntry[b + 1]);
+            }
+        });
+    }
+    const std::vector<Transaction>& all() const { return entries; }
+    
+    std::vector<Transaction> forAccount(const std::string& accountNumber) const {
+        std::vector<Transaction> accountEntries;
+        for (std::size_t index : timeline.entriesFor(accountNumber)) {
+            accountEntries.push_back(entries[index]);
+        }
+        return accountEntries;
+    }
+    bool balanceAt(const std::string& accountNumber, std::time_t timestamp, long long& balanceCents) const {
+        return timeline.balanceAt(entries, accountNumber, timestamp, balanceCents);
+    }
+};
+
+struct NoHistory {
+    static constexpr bool kEnabled = false;
+    
+    void accountOpened(const std::string&, long long, std::time_t) {}
+    void append(const Transaction&) {}
+    void appendBatches(std::vector<std::vector<Transaction>>&&, unsigned) {}
+    const std::vector<Transaction>& all() const {
+        static const std::vector<Transaction> none;
+        return none;
+    }
+    std::vector<Transaction> forAccount(const std::string&) const { return {}; }
+    bool balanceAt(const std::string&, std::time_t, long long&) const { return false; }
+};
+
+// ==================== Persistence sink ====================
+
+// Forwards changes to a runtime-attached LedgerJournal (replication log etc.)
+class JournalSink {
+private:
+    LedgerJournal* journal = nullptr;
+    
+public:
+    static constexpr bool kEnabled = true;
+    
+    void setJournal(LedgerJournal* ledgerJournal) { journal = ledgerJournal; }
+    bool active() const { return journal != nullptr; }
+    void accountCreated(const Account& account, std::time_t openedAt) { journal->accountCreated(account, openedAt); }
+    void transactionRecorded(const Transaction& txn, long long balanceAfterCents) {
+        journal->transactionRecorded(txn, balanceAfterCents);
+    }
+    void transferRecorded(const Transaction& debit, const Transaction& credit) {
+        journal->transferRecorded(debit, debit.getBalanceAfter(), credit, credit.getBalanceAfter());
+    }
+    std::uint64_t sequence() const { return journal ? journal->getSequence() : 0; }
+    LedgerJournal* getJournal() const { return journal; }
+};
+
+// Discards everything; attaching a journal has no effect
+struct NullSink {
+    static constexpr bool kEnabled = false;
+    
+    void setJournal(LedgerJournal*) {}
+    bool active() const { return false; }
+    void accountCreated(const Account&, std::time_t) {}
+    void transactionRecorded(const Transaction&, long long) {}
+    void transferRecorded(const Transaction&, const Transaction&) {}
+    std::uint64_t sequence() const { return 0; }
+    LedgerJournal* getJournal() const { return nullptr; }
+};
+
+// ==================== Instrumentation ====================
+
+enum class LedgerOperation {
+    CREATE_ACCOUNT,
+    DEPOSIT,
+    WITHDRAWAL,
+    TRANSFER,
+    PLACE_HOLD,
+    CAPTURE_HOLD,
+    RELEASE_HOLD,
+    COUNT
+};
+
+struct NoInstrumentation {
+    void operationCompleted(LedgerOperation, bool) {}
+};
+
+// Lock-free success/failure counters per operation
+class CountingInstrumentation {
+private:
+    static constexpr int kOperations = static_cast<int>(LedgerOperation::COUNT);
+    std::atomic<std::uint64_t> succeeded[kOperations] = {};
+    std::atomic<std::uint64_t> failed[kOperations] = {};
+    
+public:
+    void operationCompleted(LedgerOperation op, bool ok) {
+        auto& counter = ok ? succeeded[static_cast<int>(op)] : failed[static_cast<int>(op)];
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    std::uint64_t getSucceeded(LedgerOperation op) const {
+        return succeeded[static_cast<int>(op)].load(std::memory_order_relaxed);
+    }
+    std::uint64_t getFailed(LedgerOperation op) const {
+        return failed[static_cast<int>(op)].load(std::memory_order_relaxed);
+    }
+};
+
+// ==================== Fault injection ====================
+
+// shouldFail() decides recoverable faults (a transfer phase failing);
+// crashIfDue() models the process dying at a crash-type point.
+
+struct NoFaults {
+    void setInjector(FaultInjector*) {}
+    FaultInjector* getInjector() const { return nullptr; }
+    bool shouldFail(FaultPoint) { return false; }
+    void crashIfDue(FaultPoint) {}
+};
+
+// Consults a runtime-attached FaultInjector at every recoverable fault
+// point. Never crashes: production ledgers have no SimulatedCrash path.
+class InjectableFaults {
+private:
+    FaultInjector* injector = nullptr;
+    
+public:
+    void setInjector(FaultInjector* faultInjector) { injector = faultInjector; }
+    FaultInjector* getInjector() const { return injector; }
+    bool shouldFail(FaultPoint point) { return injector && injector->shouldFail(point); }
+    void crashIfDue(FaultPoint) {}
+};
+
+// InjectableFaults plus crash points, which throw SimulatedCrash.
+// For the fault harness only.
+class CrashingFaults : public InjectableFaults {
+public:
+    void crashIfDue(FaultPoint point) {
+        if (shouldFail(point)) {
+            throw SimulatedCrash(point);
+        }
+    }
+};
+
+// ==================== Secondary indexes ====================
+
+// AccountIndex (holder prefix + ordered balance) satisfies this interface directly
+struct NoIndex {
+    static constexpr bool kEnabled = false;
+    
+    void accountAdded(const Account&) {}
+    void balanceChanged(const Account&, long long) {}
+    void rebuildBalances(const std::vector<std::pair<long long, const Account*>>&) {}
+    std::vector<const Account*> findByHolderPrefix(const std::string&, std::size_t) const { return {}; }
+    std::vector<const Account*> largestBalances(std::size_t) const { return {}; }
+    std::vector<const Account*> balancesInRange(long long, long long, std::size_t) const { return {}; }
+};
+
+// ==================== Authorization holds ====================
+
+// AuthorizationHolds satisfies this interface directly. Without holds,
+// placeHold() always fails and nothing ever expires.
+struct NoHolds {
+    static constexpr bool kEnabled = false;
+    
+    bool empty() const { return true; }
+    std::size_t size() const { return 0; }
+    std::uint64_t open(Account&, long long, std::time_t) { return 0; }
+    const AuthorizationHolds::Hold* find(std::uint64_t) const { return nullptr; }
+    bool close(std::uint64_t, AuthorizationHolds::Hold&) { return false; }
+    const std::vector<std::pair<std::uint64_t, AuthorizationHolds::Hold>>& expire(std::time_t) {
+        static const std::vector<std::pair<std::uint64_t, AuthorizationHolds::Hold>> none;
+        return none;
+    }
+};
+
+// ==================== Velocity limits ====================
+
+// VelocityLimiter satisfies this interface directly. Without limits every
+// debit is allowed and setVelocityLimits() is ignored.
+struct NoVelocityLimits {
+    static constexpr bool kEnabled = false;
+    
+    void setRules(const std::vector<VelocityRule>&) {}
+    bool active() const { return false; }
+    bool allows(const Account&, VelocityScope, long long, std::time_t) { return true; }
+    void record(const Account&, VelocityScope, long long, std::time_t) {}
+};
+
+// ==================== Policy bundles ====================
+
+template <typename Lock, typename History, typename Sink, typename Instrumentation, typename Faults,
+          typename Index, typename Holds, typename Velocity>
+struct LedgerPolicies {
+    using LockPolicy = Lock;
+    using HistoryPolicy = History;
+    using SinkPolicy = Sink;
+    using InstrumentationPolicy = Instrumentation;
+    using FaultPolicy = Faults;
+    using IndexPolicy = Index;
+    using HoldPolicy = Holds;
+    using VelocityPolicy = Velocity;
+};
+
+// Single-threaded, full history, optional journal: the classic Ledger
+using DefaultLedgerPolicies =
+    LedgerPolicies<NoLocking, VectorHistory, JournalSink, NoInstrumentation, InjectableFaults, AccountIndex,
+                   AuthorizationHolds, VelocityLimiter>;
+
+// Balance-only replays: no locks, history, journal, counters, faults, indexes,
+// holds or velocity limits
+using BatchLedgerPolicies =
+    LedgerPolicies<NoLocking, NoHistory, NullSink, NoInstrumentation, NoFaults, NoIndex, NoHolds,
+                   NoVelocityLimits>;
+
+// Online service: serialised access and operation counters
+using ConcurrentLedgerPolicies =
+    LedgerPolicies<MutexLocking, VectorHistory, JournalSink, CountingInstrumentation, InjectableFaults,
+                   AccountIndex, AuthorizationHolds, VelocityLimiter>;
+
+// The classic Ledger with crash points enabled, for fault_harness
+using FaultHarnessLedgerPolicies =
+    LedgerPolicies<NoLocking, VectorHistory, JournalSink, NoInstrumentation, CrashingFaults, AccountIndex,
+                   AuthorizationHolds, VelocityLimiter>;
+
+#endif // LEDGERPOLICIES_H
@@ -1,9 +1,41 @@
 #include "PersistenceManager.h"
+#include "TransactionArchive.h"
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <filesystem>
 
+namespace {
+
+// Position just past the history entry with ID `lastSavedId`, or 0 if the
+// history does not contain it (nothing from this ledger was saved yet).
+// The history only grows, so everything from there on is unsaved.
+std::size_t firstUnsavedEntry(const std::vector<Transaction>& history, const std::string& lastSavedId) {
+    if (lastSavedId.empty()) {
+        return 0;
+    }
+    for (std::size_t i = history.size(); i > 0; --i) {
+        if (history[i - 1].getTransactionId() == lastSavedId) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+// ID of a record written by saveTransactions ("[time] ID: <id> | ..."),
+// or empty if `record` is not one
+std::string recordTransactionId(const std::string& record) {
+    const std::string marker = "ID: ";
+    std::size_t start = record.find(marker);
+    if (start == std::string::npos) {
+        return "";
+    }
+    start += marker.size();
+    return record.substr(start, record.find(" |", start) - start);
+}
+
+} // namespace
+
 PersistenceManager::PersistenceManager(const std::string& accountsFile,
                                        const std::string& transactionsFile)
     : accountsFilePath(accountsFile), transactionsFilePath(transactionsFile) {}
@@ -69,20 +101,22 @@ bool PersistenceManager::loadAccounts(Ledger& ledger) {
 }
 
 bool PersistenceManager::saveTransactions(const Ledger& ledger) {
-    std::ofstream file(transactionsFilePath, std::ios::app);  // Append mode
-    if (!file.is_open()) {
-        std::cerr << "Error opening " << transactionsFilePath << " for writing." << std::endl;
+    AuditLogWriter writer(transactionsFilePath);  // Appends, continuing the existing chain
+    if (!writer.open()) {
         return false;
     }
     
+    // Continue after the newest transaction already in the log, so saving
+    // the same ledger again only appends what is new
     auto transactions = ledger.getTransactionHistory();
-    
-    for (const auto& txn : transactions) {
-        file << txn.getFormattedString() << std::endl;
+    std::size_t first = firstUnsavedEntry(transactions, recordTransactionId(writer.getLastRecord()));
+    for (std::size_t i = first; i < transactions.size(); ++i) {
+        if (!writer.append(transactions[i].getFormattedString())) {
+            return false;
+        }
     }
     
-    file.close();
-    return true;
+    return writer.close();
 }
 
 bool PersistenceManager::loadTransactions(Ledger& /* ledger */) {
@@ -106,3 +140,40 @@ bool PersistenceManager::loadTransactions(Ledger& /* ledger */) {
     file.close();
     return true;
 }
+
+bool PersistenceManager::verifyTransactions(AuditVerifyReport& report, unsigned threads) const {
+    return verifyAuditLog(transactionsFilePath, threads, report);
+}
+
+bool PersistenceManager::archiveTransactions(const Ledger& ledger, const std::string& archiveFile) {
+    // Continue after the newest transaction already in the archive, so
+    // archiving the same ledger again only adds what is new
+    std::string lastArchivedId;
+    std::error_code error;
+    if (fileExists(archiveFile) && std::filesystem::file_size(archiveFile, error) > 0) {
+        TransactionArchiveReader reader(archiveFile);
+        if (!reader.load()) {
+            return false;
+        }
+        reader.getLastTransactionId(lastArchivedId);
+    }
+    
+    auto transactions = ledger.getTransactionHistory();
+    std::size_t first = firstUnsavedEntry(transactions, lastArchivedId);
+    if (first == transactions.size()) {
+        return true;  // Nothing new since the last call
+    }
+    
+    TransactionArchiveWriter writer(archiveFile);
+    if (!writer.open()) {
+        return false;
+    }
+    
+    for (std::size_t i = first; i < transactions.size(); ++i) {
+        if (!writer.append(transactions[i])) {
+            return false;
+        }
+    }
+    
+    return writer.close();
+}
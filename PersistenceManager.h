@@ -1,6 +1,7 @@
 #ifndef PERSISTENCEMANAGER_H
 #define PERSISTENCEMANAGER_H
 
+#include "AuditLog.h"
 #include "Ledger.h"
 #include <string>
 
@@ -17,9 +18,18 @@ public:
     bool saveAccounts(const Ledger& ledger);
     bool loadAccounts(Ledger& ledger);
     
+    // Transactions are appended to a hash-chained audit log (see AuditLog.h).
+    // Transactions saved by an earlier call are not appended again.
     bool saveTransactions(const Ledger& ledger);
     bool loadTransactions(Ledger& ledger);
     
+    // Checks the transaction log's hash chain and segment checkpoints in parallel
+    bool verifyTransactions(AuditVerifyReport& report, unsigned threads = 0) const;
+    
+    // Seals the history into a compressed columnar archive. Transactions
+    // archived by an earlier call are not appended again.
+    bool archiveTransactions(const Ledger& ledger, const std::string& archiveFile = "transactions.arc");
+    
     // Utility
     bool fileExists(const std::string& filePath) const;
 };
@@ -0,0 +1,281 @@
+#include "ReplicationLog.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+long long nowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string escapeField(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '|') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+const std::size_t TRANSACTION_FIELDS = 10;
+
+std::string transactionFields(const Transaction& txn, long long balanceAfterCents) {
+    return escapeField(txn.getTransactionId()) + "|" +
+           escapeField(txn.getAccountNumber()) + "|" +
+           std::to_string(txn.getAmount()) + "|" +
+           std::to_string(static_cast<int>(txn.getType())) + "|" +
+           std::to_string(static_cast<int>(txn.getStatus())) + "|" +
+           std::to_string(static_cast<long long>(txn.getTimestamp())) + "|" +
+           std::to_string(balanceAfterCents) + "|" +
+           escapeField(txn.getRelatedAccountNumber()) + "|" +
+           escapeField(txn.getDescription()) + "|" +
+           escapeField(txn.getFailureReason());
+}
+
+// Parses the TRANSACTION_FIELDS fields starting at `first`; throws on bad numbers
+Transaction parseTransaction(const std::vector<std::string>& fields, std::size_t first, long long& balanceAfterCents) {
+    balanceAfterCents = std::stoll(fields[first + 6]);
+    Transaction txn(fields[first], fields[first + 1], std::stoll(fields[first + 2]),
+                    static_cast<TransactionType>(std::stoi(fields[first + 3])),
+                    static_cast<TransactionStatus>(std::stoi(fields[first + 4])),
+                    static_cast<std::time_t>(std::stoll(fields[first + 5])),
+                    fields[first + 8], fields[first + 7]);
+    txn.setFailureReason(fields[first + 9]);
+    return txn;
+}
+
+std::vector<std::string> splitRecord(const std::string& record) {
+    std::vector<std::string> fields(1);
+    for (std::size_t i = 0; i < record.size(); ++i) {
+        char c = record[i];
+        if (c == '\\' && i + 1 < record.size()) {
+            char next = record[++i];
+            fields.back() += (next == 'n') ? '\n' : next;
+        } else if (c == '|') {
+            fields.emplace_back();
+        } else {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+} // namespace
+
+// ==================== Primary ====================
+
+ReplicationLogWriter::ReplicationLogWriter(const std::string& logFile)
+    : logFilePath(logFile), log(logFile, true), sequence(0), faults(nullptr) {
+    // A random epoch ID lets replicas tell a restarted primary's log apart
+    // from the old one even when it has already grown past their read offset
+    std::uint64_t epochId = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^
+                            static_cast<std::uint64_t>(nowMillis());
+    if (log.isOpen()) {
+        log.append("E|" + std::to_string(epochId) + "|" + std::to_string(nowMillis()) + "\n");
+    }
+}
+
+bool ReplicationLogWriter::isOpen() const {
+    return log.isOpen();
+}
+
+std::uint64_t ReplicationLogWriter::getSequence() const {
+    return sequence;
+}
+
+// The epoch header is the log's first append, so record N is append N + 1
+bool ReplicationLogWriter::waitDurable(std::uint64_t recordSequence) {
+    return log.waitDurable(recordSequence + 1);
+}
+
+std::uint64_t ReplicationLogWriter::getDurableSequence() const {
+    std::uint64_t durable = log.getDurableSequence();
+    return durable > 0 ? durable - 1 : 0;
+}
+
+void ReplicationLogWriter::setFaultInjector(FaultInjector* injector) {
+    faults = injector;
+}
+
+void ReplicationLogWriter::writeRecord(const std::string& record) {
+    if (!log.isOpen()) {
+        return;
+    }
+
+    // Simulated crashes first drain what was already queued, so the log
+    // ends exactly where a synchronous writer's would have
+    if (faults && faults->shouldFail(FaultPoint::PERSIST_BEFORE_WRITE)) {
+        log.waitDurable(log.getAppendedSequence());
+        throw SimulatedCrash(FaultPoint::PERSIST_BEFORE_WRITE);
+    }
+    if (faults && faults->shouldFail(FaultPoint::PERSIST_TORN_WRITE)) {
+        log.waitDurable(log.append(record.substr(0, record.size() / 2)));
+        throw SimulatedCrash(FaultPoint::PERSIST_TORN_WRITE);
+    }
+
+    // One append per record keeps the log's sequence numbers in step with
+    // ours; the writer thread hands batches to the disk as soon as it is idle, so
+    // tailing replicas still see records promptly
+    log.append(record + '\n');
+}
+
+void ReplicationLogWriter::accountCreated(const Account& account, std::time_t openedAt) {
+    writeRecord("A|" + std::to_string(++sequence) + "|" + std::to_string(nowMillis()) + "|" +
+                escapeField(account.getAccountNumber()) + "|" +
+                escapeField(account.getAccountHolder()) + "|" +
+                std::to_string(account.getBalance()) + "|" +
+                std::to_string(static_cast<long long>(openedAt)));
+}
+
+void ReplicationLogWriter::transactionRecorded(const Transaction& txn, long long balanceAfterCents) {
+    writeRecord("T|" + std::to_string(++sequence) + "|" + std::to_string(nowMillis()) + "|" +
+                transactionFields(txn, balanceAfterCents));
+}
+
+void ReplicationLogWriter::transferRecorded(const Transaction& debit, long long debitBalanceAfterCents,
+                                            const Transaction& credit, long long creditBalanceAfterCents) {
+    writeRecord("X|" + std::to_string(++sequence) + "|" + std::to_string(nowMillis()) + "|" +
+                transactionFields(debit, debitBalanceAfterCents) + "|" +
+                transactionFields(credit, creditBalanceAfterCents));
+}
+
+// ==================== Replica ====================
+
+ReplicaLedger::ReplicaLedger(const std::string& logFile)
+    : logFilePath(logFile), ledger(new Ledger()), readOffset(0) {}
+
+std::size_t ReplicaLedger::poll() {
+    std::error_code ec;
+    std::uint64_t fileSize = std::filesystem::file_size(logFilePath, ec);
+    if (ec) {
+        return 0;  // Primary has not created the log yet
+    }
+
+    std::ifstream file(logFilePath, std::ios::binary);
+    if (!file.is_open()) {
+        return 0;
+    }
+
+    // Every primary run starts the log with a new epoch header
+    std::string header;
+    if (!std::getline(file, header) || file.eof()) {
+        return 0;  // Header not written yet
+    }
+    if (header.compare(0, 2, "E|") != 0) {
+        std::cerr << "Replication log " << logFilePath << " has no epoch header." << std::endl;
+        return 0;
+    }
+    Ledger* target = ledger.get();
+    ReplicationStatus progress = status;
+    std::unique_ptr<Ledger> rebuilt;
+    if (header != epochHeader || fileSize < readOffset) {
+        if (!epochHeader.empty()) {
+            // Replay the new epoch into a fresh ledger; queries keep seeing
+            // the old state until it is swapped in below
+            rebuilt.reset(new Ledger());
+            target = rebuilt.get();
+            progress.appliedSequence = 0;
+            ++progress.epochs;
+        }
+        epochHeader = header;
+        readOffset = header.size() + 1;
+    }
+    file.seekg(static_cast<std::streamoff>(readOffset));
+
+    std::size_t applied = 0;
+    std::string record;
+    while (std::getline(file, record)) {
+        if (file.eof()) {
+            break;  // Incomplete trailing record; re-read it on the next poll
+        }
+        std::uint64_t recordOffset = readOffset;
+        readOffset += record.size() + 1;
+
+        ApplyResult result = applyRecord(*target, progress, record);
+        if (result == ApplyResult::APPLIED) {
+            ++applied;
+        } else if (result == ApplyResult::MALFORMED) {
+            std::cerr << "Skipping malformed replication record at offset " << recordOffset << "." << std::endl;
+        } else {
+            // Applying it would double-count a change the replica already has
+            std::cerr << "Skipping replication record at offset " << recordOffset << ": its sequence number "
+                      << "is at or below the last applied (" << progress.appliedSequence << ")." << std::endl;
+            ++progress.outOfOrder;
+        }
+    }
+
+    if (rebuilt) {
+        ledger = std::move(rebuilt);
+    }
+    status = progress;
+    status.pendingBytes = fileSize > readOffset ? fileSize - readOffset : 0;
+    return applied;
+}
+
+ReplicaLedger::ApplyResult ReplicaLedger::applyRecord(Ledger& target, ReplicationStatus& progress,
+                                                      const std::string& record) {
+    std::vector<std::string> fields = splitRecord(record);
+
+    try {
+        if (fields.size() < 3) {
+            return ApplyResult::MALFORMED;
+        }
+        std::uint64_t sequence = std::stoull(fields[1]);
+        if (sequence <= progress.appliedSequence) {
+            return ApplyResult::OUT_OF_ORDER;
+        }
+
+        if (fields[0] == "A" && fields.size() == 7) {
+            target.replayAccount(fields[3], fields[4], std::stoll(fields[5]),
+                                  static_cast<std::time_t>(std::stoll(fields[6])));
+        } else if (fields[0] == "T" && fields.size() == 3 + TRANSACTION_FIELDS) {
+            long long balanceAfter = 0;
+            Transaction txn = parseTransaction(fields, 3, balanceAfter);
+            if (!target.replayTransaction(txn, balanceAfter)) {
+                return ApplyResult::MALFORMED;
+            }
+        } else if (fields[0] == "X" && fields.size() == 3 + 2 * TRANSACTION_FIELDS) {
+            long long debitBalanceAfter = 0;
+            long long creditBalanceAfter = 0;
+            Transaction debit = parseTransaction(fields, 3, debitBalanceAfter);
+            Transaction credit = parseTransaction(fields, 3 + TRANSACTION_FIELDS, creditBalanceAfter);
+            // Check both accounts first so a transfer is never half-applied
+            if (!target.accountExists(debit.getAccountNumber()) ||
+                !target.accountExists(credit.getAccountNumber())) {
+                return ApplyResult::MALFORMED;
+            }
+            target.replayTransaction(debit, debitBalanceAfter);
+            target.replayTransaction(credit, creditBalanceAfter);
+        } else {
+            return ApplyResult::MALFORMED;
+        }
+
+        progress.appliedSequence = sequence;
+        progress.lagMillis = nowMillis() - std::stoll(fields[2]);
+    } catch (const std::exception&) {
+        return ApplyResult::MALFORMED;
+    }
+
+    ++progress.appliedRecords;
+    return ApplyResult::APPLIED;
+}
+
+ReplicationStatus ReplicaLedger::getStatus() const {
+    return status;
+}
+
+const Ledger& ReplicaLedger::getLedger() const {
+    return *ledger;
+}
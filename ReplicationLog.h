@@ -0,0 +1,97 @@
+#ifndef REPLICATIONLOG_H
+#define REPLICATIONLOG_H
+
+#include "AsyncLogWriter.h"
+#include "FaultInjector.h"
+#include "Ledger.h"
+#include "LedgerJournal.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Primary side: writes every ledger change to an append-only log that
+// replicas tail. One record per line, after an epoch header:
+//   E|epochId|primaryMillis
+//   A|seq|primaryMillis|accountNumber|holder|balanceCents|openedAt
+//   T|seq|primaryMillis|txnId|accountNumber|amount|type|status|timestamp|balanceAfter|related|description|
+//     failureReason
+//   X|seq|primaryMillis|<debit transaction fields>|<credit transaction fields>
+// An X record holds both legs of a transfer (the ten fields after
+// primaryMillis in a T record, twice), so a crash can never persist a
+// debit without its credit.
+// Text fields escape '\', '|' and newlines with a backslash. Sequence
+// numbers start at 1 in every epoch and only increase.
+// Records are written and synced by a background AsyncLogWriter, so the
+// ledger never waits on the disk unless it asks to with waitDurable().
+class ReplicationLogWriter : public LedgerJournal {
+private:
+    std::string logFilePath;
+    AsyncLogWriter log;             // Its sequence numbers run one ahead of ours (the header)
+    std::uint64_t sequence;
+    FaultInjector* faults;
+
+    void writeRecord(const std::string& record);
+
+public:
+    // Truncates the log and writes a new epoch header: each primary run
+    // starts a new replication epoch
+    explicit ReplicationLogWriter(const std::string& logFile = "replication.log");
+
+    bool isOpen() const;
+    std::uint64_t getSequence() const override;
+
+    // Blocks until every record up to `recordSequence` is on stable storage
+    bool waitDurable(std::uint64_t recordSequence) override;
+    std::uint64_t getDurableSequence() const;
+    
+    // Enables the PERSIST_* fault points, which throw SimulatedCrash
+    void setFaultInjector(FaultInjector* injector);
+
+    void accountCreated(const Account& account, std::time_t openedAt) override;
+    void transactionRecorded(const Transaction& txn, long long balanceAfterCents) override;
+    void transferRecorded(const Transaction& debit, long long debitBalanceAfterCents,
+                          const Transaction& credit, long long creditBalanceAfterCents) override;
+};
+
+struct ReplicationStatus {
+    std::uint64_t appliedSequence = 0;   // Sequence number of the last applied record
+    std::uint64_t appliedRecords = 0;
+    std::uint64_t pendingBytes = 0;      // Bytes written by the primary but not yet applied
+    long long lagMillis = 0;             // Primary write -> replica apply delay of the last record
+    std::uint64_t epochs = 0;            // Number of times the primary restarted the log
+    std::uint64_t outOfOrder = 0;        // Records skipped because their sequence number did not increase
+};
+
+// Replica side: a read-only Ledger kept up to date by tailing the primary's
+// replication log. Queries never touch the primary process.
+class ReplicaLedger {
+private:
+    enum class ApplyResult {
+        APPLIED,
+        MALFORMED,      // Skipped
+        OUT_OF_ORDER    // Sequence number did not increase within the epoch: skipped
+    };
+
+    std::string logFilePath;
+    std::unique_ptr<Ledger> ledger;
+    std::string epochHeader;        // Header of the epoch being followed; empty before the first poll
+    std::uint64_t readOffset;
+    ReplicationStatus status;
+
+    ApplyResult applyRecord(Ledger& target, ReplicationStatus& progress, const std::string& record);
+
+public:
+    explicit ReplicaLedger(const std::string& logFile = "replication.log");
+
+    // Applies every complete record appended since the last call.
+    // Returns the number of records applied. A new epoch header (primary
+    // restart) replays the new log into a fresh ledger, which replaces the
+    // current one once it has caught up. Within an epoch, a record whose
+    // sequence number does not increase is corrupt and is skipped.
+    std::size_t poll();
+
+    ReplicationStatus getStatus() const;
+    const Ledger& getLedger() const;
+};
+
+#endif // REPLICATIONLOG_H
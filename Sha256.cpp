@@ -0,0 +1,259 @@
+#include "Sha256.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SHA256_X86_EXTENSIONS 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const std::uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+inline std::uint32_t rotr(std::uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+void compressPortable(std::uint32_t state[8], const std::uint8_t* blocks, std::size_t count) {
+    std::uint32_t w[64];
+    for (; count > 0; --count, blocks += 64) {
+        for (int t = 0; t < 16; ++t) {
+            w[t] = (static_cast<std::uint32_t>(blocks[4 * t]) << 24) |
+                   (static_cast<std::uint32_t>(blocks[4 * t + 1]) << 16) |
+                   (static_cast<std::uint32_t>(blocks[4 * t + 2]) << 8) |
+                   static_cast<std::uint32_t>(blocks[4 * t + 3]);
+        }
+        for (int t = 16; t < 64; ++t) {
+            std::uint32_t s0 = rotr(w[t - 15], 7) ^ rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+            std::uint32_t s1 = rotr(w[t - 2], 17) ^ rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+        
+        std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        std::uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int t = 0; t < 64; ++t) {
+            std::uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[t] + w[t];
+            std::uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+#ifdef SHA256_X86_EXTENSIONS
+// Four rounds per step with SHA256RNDS2; the message schedule is kept in
+// four registers of four words each and extended with SHA256MSG1/MSG2.
+__attribute__((target("sha,sse4.1")))
+void compressHardware(std::uint32_t state[8], const std::uint8_t* blocks, std::size_t count) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    
+    // The instructions want the state as ABEF / CDGH
+    __m128i cdab = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xB1);
+    __m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1B);
+    __m128i abef = _mm_alignr_epi8(cdab, efgh, 8);
+    __m128i cdgh = _mm_blend_epi16(efgh, cdab, 0xF0);
+    
+    for (; count > 0; --count, blocks += 64) {
+        const __m128i abefSaved = abef;
+        const __m128i cdghSaved = cdgh;
+        
+        __m128i msg[4];
+        for (int i = 0; i < 4; ++i) {
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16 * i)), byteSwap);
+        }
+        
+        for (int step = 0; step < 16; ++step) {
+            __m128i wk = _mm_add_epi32(msg[step & 3], _mm_loadu_si128(reinterpret_cast<const __m128i*>(&K[4 * step])));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0E));
+            
+            if (step < 12) {
+                // W[t..t+3] from W[t-16..t-13], W[t-15..t-12], W[t-7..t-4] and W[t-2..t-1]
+                __m128i next = _mm_sha256msg1_epu32(msg[step & 3], msg[(step + 1) & 3]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(msg[(step + 3) & 3], msg[(step + 2) & 3], 4));
+                msg[step & 3] = _mm_sha256msg2_epu32(next, msg[(step + 3) & 3]);
+            }
+        }
+        
+        abef = _mm_add_epi32(abef, abefSaved);
+        cdgh = _mm_add_epi32(cdgh, cdghSaved);
+    }
+    
+    // Back to ABCD / EFGH
+    __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+    __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+bool cpuHasShaExtensions() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1) || !(ecx & bit_SSSE3)) {
+        return false;
+    }
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (ebx & bit_SHA) != 0;
+}
+
+const bool kHasHardware = cpuHasShaExtensions();
+#else
+const bool kHasHardware = false;
+#endif
+
+std::atomic<bool> useHardware(kHasHardware);  // Cleared by forcePortable()
+
+} // namespace
+
+Sha256::Sha256() : state{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                         0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19},
+                   buffered(0), totalBytes(0) {}
+
+void Sha256::compress(std::uint32_t state[8], const std::uint8_t* blocks, std::size_t count) {
+#ifdef SHA256_X86_EXTENSIONS
+    if (useHardware.load(std::memory_order_relaxed)) {
+        compressHardware(state, blocks, count);
+        return;
+    }
+#endif
+    compressPortable(state, blocks, count);
+}
+
+void Sha256::update(const void* data, std::size_t length) {
+    if (length == 0) {
+        return;
+    }
+    const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+    totalBytes += length;
+    
+    if (buffered > 0) {
+        std::size_t take = std::min(length, sizeof(buffer) - buffered);
+        std::memcpy(buffer + buffered, bytes, take);
+        buffered += take;
+        bytes += take;
+        length -= take;
+        if (buffered < sizeof(buffer)) {
+            return;
+        }
+        compress(state, buffer, 1);
+        buffered = 0;
+    }
+    
+    // Whole blocks straight from the caller's memory
+    std::size_t blocks = length / 64;
+    if (blocks > 0) {
+        compress(state, bytes, blocks);
+        bytes += blocks * 64;
+        length -= blocks * 64;
+    }
+    
+    std::memcpy(buffer, bytes, length);
+    buffered = length;
+}
+
+void Sha256::update(const std::string& data) {
+    update(data.data(), data.size());
+}
+
+Sha256::Digest Sha256::finish() {
+    const std::uint64_t bitLength = totalBytes * 8;
+    
+    // 0x80, zero padding, then the 64-bit big-endian message length
+    buffer[buffered++] = 0x80;
+    if (buffered > 56) {
+        std::memset(buffer + buffered, 0, sizeof(buffer) - buffered);
+        compress(state, buffer, 1);
+        buffered = 0;
+    }
+    std::memset(buffer + buffered, 0, 56 - buffered);
+    for (int i = 0; i < 8; ++i) {
+        buffer[56 + i] = static_cast<std::uint8_t>(bitLength >> (56 - 8 * i));
+    }
+    compress(state, buffer, 1);
+    
+    Digest digest;
+    for (int i = 0; i < 8; ++i) {
+        digest[4 * i] = static_cast<std::uint8_t>(state[i] >> 24);
+        digest[4 * i + 1] = static_cast<std::uint8_t>(state[i] >> 16);
+        digest[4 * i + 2] = static_cast<std::uint8_t>(state[i] >> 8);
+        digest[4 * i + 3] = static_cast<std::uint8_t>(state[i]);
+    }
+    return digest;
+}
+
+Sha256::Digest Sha256::hash(const void* data, std::size_t length) {
+    Sha256 hasher;
+    hasher.update(data, length);
+    return hasher.finish();
+}
+
+std::string Sha256::toHex(const Digest& digest) {
+    static const char kHexDigits[] = "0123456789abcdef";
+    std::string hex(digest.size() * 2, '0');
+    for (std::size_t i = 0; i < digest.size(); ++i) {
+        hex[2 * i] = kHexDigits[digest[i] >> 4];
+        hex[2 * i + 1] = kHexDigits[digest[i] & 0x0F];
+    }
+    return hex;
+}
+
+bool Sha256::fromHex(const std::string& hex, Digest& digest) {
+    return fromHex(hex.data(), hex.size(), digest);
+}
+
+bool Sha256::fromHex(const char* hex, std::size_t length, Digest& digest) {
+    if (length != digest.size() * 2) {
+        return false;
+    }
+    
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+    for (std::size_t i = 0; i < digest.size(); ++i) {
+        int high = nibble(hex[2 * i]);
+        int low = nibble(hex[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        digest[i] = static_cast<std::uint8_t>((high << 4) | low);
+    }
+    return true;
+}
+
+bool Sha256::hardwareAccelerated() {
+    return useHardware.load(std::memory_order_relaxed);
+}
+
+void Sha256::forcePortable(bool portable) {
+    useHardware.store(kHasHardware && !portable, std::memory_order_relaxed);
+}
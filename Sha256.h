@@ -0,0 +1,44 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// SHA-256 (FIPS 180-4). Uses the x86 SHA extensions when the CPU has them
+// (checked once at startup) and a portable implementation otherwise.
+class Sha256 {
+public:
+    using Digest = std::array<std::uint8_t, 32>;
+    
+private:
+    std::uint32_t state[8];
+    std::uint8_t buffer[64];
+    std::size_t buffered;
+    std::uint64_t totalBytes;
+    
+    static void compress(std::uint32_t state[8], const std::uint8_t* blocks, std::size_t count);
+    
+public:
+    Sha256();
+    
+    void update(const void* data, std::size_t length);
+    void update(const std::string& data);
+    Digest finish();  // The hasher must not be reused afterwards
+    
+    static Digest hash(const void* data, std::size_t length);
+    
+    static std::string toHex(const Digest& digest);
+    static bool fromHex(const std::string& hex, Digest& digest);
+    static bool fromHex(const char* hex, std::size_t length, Digest& digest);
+    
+    // True if the hardware (SHA extensions) path is in use
+    static bool hardwareAccelerated();
+    
+    // Switches to the portable path even on capable CPUs (or back), so both
+    // can be tested. Not for use while other threads are hashing.
+    static void forcePortable(bool portable);
+};
+
+#endif // SHA256_H
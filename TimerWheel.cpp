@@ -0,0 +1,141 @@
+#include "TimerWheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel(std::uint64_t startTick)
+    : slots(kLevels * kSlots, kInvalidTimer), freeList(kInvalidTimer), currentTick(startTick), activeCount(0) {}
+
+void TimerWheel::link(TimerId id) {
+    Node& node = nodes[id];
+    std::uint64_t delta = node.deadline > currentTick ? node.deadline - currentTick : 0;
+    std::uint64_t deadline = node.deadline;
+    
+    // Pick the lowest level whose span covers the remaining delay
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (std::uint64_t(1) << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+    if (level == kLevels - 1 && delta >> (kSlotBits * kLevels)) {
+        // Beyond the wheel's range: park in the furthest slot and re-file on cascade
+        deadline = currentTick + (std::uint64_t(1) << (kSlotBits * kLevels)) - 1;
+    }
+    
+    std::uint32_t slot = level * kSlots + ((deadline >> (kSlotBits * level)) & kSlotMask);
+    node.slot = slot;
+    node.prev = kInvalidTimer;
+    node.next = slots[slot];
+    if (node.next != kInvalidTimer) {
+        nodes[node.next].prev = id;
+    }
+    slots[slot] = id;
+    ++levelCounts[level];
+}
+
+void TimerWheel::unlink(TimerId id) {
+    Node& node = nodes[id];
+    if (node.prev != kInvalidTimer) {
+        nodes[node.prev].next = node.next;
+    } else {
+        slots[node.slot] = node.next;
+    }
+    if (node.next != kInvalidTimer) {
+        nodes[node.next].prev = node.prev;
+    }
+    --levelCounts[node.slot / kSlots];
+}
+
+void TimerWheel::cascade(int level) {
+    std::uint32_t slot = level * kSlots + ((currentTick >> (kSlotBits * level)) & kSlotMask);
+    TimerId id = slots[slot];
+    slots[slot] = kInvalidTimer;
+    
+    // Detach the whole list first: re-filed timers may land back in this slot
+    while (id != kInvalidTimer) {
+        TimerId next = nodes[id].next;
+        --levelCounts[level];
+        link(id);
+        id = next;
+    }
+}
+
+TimerWheel::TimerId TimerWheel::schedule(std::uint64_t deadlineTick, std::uint64_t payload) {
+    TimerId id;
+    if (freeList != kInvalidTimer) {
+        id = freeList;
+        freeList = nodes[id].next;
+    } else {
+        id = static_cast<TimerId>(nodes.size());
+        nodes.push_back(Node());
+    }
+    
+    Node& node = nodes[id];
+    node.deadline = std::max(deadlineTick, currentTick + 1);  // The current tick has already fired
+    node.payload = payload;
+    link(id);
+    ++activeCount;
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    if (id >= nodes.size() || nodes[id].slot == kInvalidTimer) {
+        return false;
+    }
+    
+    unlink(id);
+    nodes[id].slot = kInvalidTimer;
+    nodes[id].next = freeList;
+    freeList = id;
+    --activeCount;
+    return true;
+}
+
+void TimerWheel::advance(std::uint64_t nowTick, std::vector<std::uint64_t>& expired) {
+    while (currentTick < nowTick) {
+        if (activeCount == 0) {
+            currentTick = nowTick;
+            break;
+        }
+        
+        // Jump to the end of the widest run of empty levels, stopping just
+        // before the boundary so the cascade there still happens
+        std::uint64_t skipTo = currentTick;
+        for (int level = 0; level < kLevels - 1 && levelCounts[level] == 0; ++level) {
+            skipTo = currentTick | ((std::uint64_t(1) << (kSlotBits * (level + 1))) - 1);
+        }
+        if (skipTo > currentTick) {
+            currentTick = std::min(skipTo, nowTick);
+            continue;
+        }
+        
+        ++currentTick;
+        
+        // Refill lower levels from the top down at each level boundary
+        for (int level = kLevels - 1; level > 0; --level) {
+            if ((currentTick & ((std::uint64_t(1) << (kSlotBits * level)) - 1)) == 0) {
+                cascade(level);
+            }
+        }
+        
+        std::uint32_t slot = static_cast<std::uint32_t>(currentTick & kSlotMask);
+        TimerId id = slots[slot];
+        slots[slot] = kInvalidTimer;
+        while (id != kInvalidTimer) {
+            Node& node = nodes[id];
+            TimerId next = node.next;
+            expired.push_back(node.payload);
+            --levelCounts[0];
+            --activeCount;
+            node.slot = kInvalidTimer;
+            node.next = freeList;
+            freeList = id;
+            id = next;
+        }
+    }
+}
+
+std::uint64_t TimerWheel::getCurrentTick() const {
+    return currentTick;
+}
+
+std::size_t TimerWheel::size() const {
+    return activeCount;
+}
@@ -0,0 +1,63 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <cstdint>
+#include <vector>
+
+// Hierarchical timing wheel (Varghese & Lauck). Four levels of 256 slots
+// cover 2^32 ticks; scheduling and cancelling are O(1), and advancing
+// touches only the slots that come due plus an occasional cascade of one
+// higher-level slot into the level below. Timers live in a pooled,
+// intrusively linked node array, so no allocation happens per timer once
+// the pool has grown.
+class TimerWheel {
+public:
+    using TimerId = std::uint32_t;
+    static constexpr TimerId kInvalidTimer = 0xFFFFFFFFu;
+    
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 8;
+    static constexpr std::uint32_t kSlots = 1u << kSlotBits;
+    static constexpr std::uint32_t kSlotMask = kSlots - 1;
+    
+    struct Node {
+        std::uint64_t deadline;
+        std::uint64_t payload;
+        TimerId prev;
+        TimerId next;
+        std::uint32_t slot;     // Index into `slots`; kInvalidTimer while free
+    };
+    
+    std::vector<Node> nodes;
+    std::vector<TimerId> slots;           // kLevels * kSlots list heads
+    std::size_t levelCounts[kLevels] = {};
+    TimerId freeList;
+    std::uint64_t currentTick;            // Last tick processed by advance()
+    std::size_t activeCount;
+    
+    void link(TimerId id);
+    void unlink(TimerId id);
+    void cascade(int level);
+    
+public:
+    explicit TimerWheel(std::uint64_t startTick = 0);
+    
+    // Fires `payload` on the first advance() reaching `deadlineTick`.
+    // Deadlines already in the past fire on the next advance().
+    TimerId schedule(std::uint64_t deadlineTick, std::uint64_t payload);
+    
+    // Returns false if the timer has already fired or been cancelled.
+    // Ids are recycled, so callers must drop an id once its timer fires.
+    bool cancel(TimerId id);
+    
+    // Processes every tick up to and including `nowTick`, appending the
+    // payloads of timers that came due to `expired` in tick order.
+    // Runs of empty slots are skipped, so long idle gaps are cheap.
+    void advance(std::uint64_t nowTick, std::vector<std::uint64_t>& expired);
+    
+    std::uint64_t getCurrentTick() const;
+    std::size_t size() const;
+};
+
+#endif // TIMERWHEEL_H
@@ -1,15 +1,35 @@
 #include "Transaction.h"
+#include <atomic>
 #include <sstream>
 #include <iomanip>
 
+namespace {
+// Atomic so bulk posting can reserve whole ID ranges up front
+std::atomic<long long> transactionCounter(0);
+}
+
 Transaction::Transaction(const std::string& accNum, long long amount, TransactionType txnType,
                          const std::string& desc, const std::string& relatedAcc)
     : transactionId(""), accountNumber(accNum), description(desc), relatedAccountNumber(relatedAcc),
-      amountCents(amount), type(txnType), timestamp(std::time(nullptr)), status(TransactionStatus::PENDING) {
+      amountCents(amount), balanceAfterCents(0), type(txnType), timestamp(std::time(nullptr)),
+      status(TransactionStatus::PENDING) {
     
     // Generate unique transaction ID
-    static int transactionCounter = 0;
-    transactionId = "TXN" + std::to_string(++transactionCounter) + "_" + std::to_string(timestamp);
+    transactionId = makeTransactionId(reserveSequenceNumbers(1), timestamp);
+}
+
+Transaction::Transaction(const std::string& txnId, const std::string& accNum, long long amount,
+                         TransactionType txnType, TransactionStatus txnStatus, std::time_t txnTimestamp,
+                         const std::string& desc, const std::string& relatedAcc)
+    : transactionId(txnId), accountNumber(accNum), description(desc), relatedAccountNumber(relatedAcc),
+      amountCents(amount), balanceAfterCents(0), type(txnType), timestamp(txnTimestamp), status(txnStatus) {}
+
+long long Transaction::reserveSequenceNumbers(long long count) {
+    return transactionCounter.fetch_add(count) + 1;
+}
+
+std::string Transaction::makeTransactionId(long long sequenceNumber, std::time_t txnTimestamp) {
+    return "TXN" + std::to_string(sequenceNumber) + "_" + std::to_string(txnTimestamp);
 }
 
 std::string Transaction::getTransactionId() const {
@@ -44,10 +64,26 @@ std::string Transaction::getRelatedAccountNumber() const {
     return relatedAccountNumber;
 }
 
+long long Transaction::getBalanceAfter() const {
+    return balanceAfterCents;
+}
+
+std::string Transaction::getFailureReason() const {
+    return failureReason;
+}
+
 void Transaction::setStatus(TransactionStatus newStatus) {
     status = newStatus;
 }
 
+void Transaction::setBalanceAfter(long long balanceCents) {
+    balanceAfterCents = balanceCents;
+}
+
+void Transaction::setFailureReason(const std::string& reason) {
+    failureReason = reason;
+}
+
 std::string Transaction::statusToString(TransactionStatus status) {
     switch (status) {
         case TransactionStatus::PENDING:
@@ -77,6 +113,18 @@ std::string Transaction::typeToString(TransactionType type) {
             return "ROLLBACK_WITHDRAWAL";
         case TransactionType::ROLLBACK_DEPOSIT:
             return "ROLLBACK_DEPOSIT";
+        case TransactionType::INTEREST_CREDIT:
+            return "INTEREST_CREDIT";
+        case TransactionType::FEE_DEBIT:
+            return "FEE_DEBIT";
+        case TransactionType::AUTHORIZATION_HOLD:
+            return "AUTHORIZATION_HOLD";
+        case TransactionType::HOLD_CAPTURE:
+            return "HOLD_CAPTURE";
+        case TransactionType::HOLD_RELEASE:
+            return "HOLD_RELEASE";
+        case TransactionType::HOLD_EXPIRY:
+            return "HOLD_EXPIRY";
         default:
             return "UNKNOWN";
     }
@@ -96,6 +144,9 @@ std::string Transaction::getFormattedString() const {
     oss << "Type: " << typeToString(type) << " | ";
     oss << "Amount: R" << (amountCents / 100.0) << " | ";
     oss << "Status: " << statusToString(status);
+    if (!failureReason.empty()) {
+        oss << " (" << failureReason << ")";
+    }
     
     if (!description.empty()) {
         oss << " | " << description;
@@ -10,7 +10,13 @@ enum class TransactionType {
     TRANSFER_OUT,
     TRANSFER_IN,
     ROLLBACK_WITHDRAWAL,
-    ROLLBACK_DEPOSIT
+    ROLLBACK_DEPOSIT,
+    INTEREST_CREDIT,
+    FEE_DEBIT,
+    AUTHORIZATION_HOLD,  // Recorded PENDING; funds reserved, balance unchanged
+    HOLD_CAPTURE,
+    HOLD_RELEASE,
+    HOLD_EXPIRY
 };
 
 enum class TransactionStatus {
@@ -26,7 +32,9 @@ private:
     std::string accountNumber;
     std::string description;
     std::string relatedAccountNumber;  // For transfers: the other account involved
+    std::string failureReason;         // Why a FAILED entry was rejected, if not the caller's error
     long long amountCents;
+    long long balanceAfterCents;  // Account balance once this entry was applied
     TransactionType type;
     std::time_t timestamp;
     TransactionStatus status;
@@ -36,6 +44,11 @@ public:
     Transaction(const std::string& accNum, long long amount, TransactionType txnType,
                 const std::string& desc = "", const std::string& relatedAcc = "");
     
+    // Restores a previously recorded transaction (e.g. when reading an archive)
+    Transaction(const std::string& txnId, const std::string& accNum, long long amount,
+                TransactionType txnType, TransactionStatus txnStatus, std::time_t txnTimestamp,
+                const std::string& desc = "", const std::string& relatedAcc = "");
+    
     // Getters
     std::string getTransactionId() const;
     std::string getAccountNumber() const;
@@ -45,12 +58,18 @@ public:
     std::time_t getTimestamp() const;
     std::string getDescription() const;
     std::string getRelatedAccountNumber() const;
+    long long getBalanceAfter() const;
+    std::string getFailureReason() const;
     
     // Setters
     void setStatus(TransactionStatus newStatus);
+    void setBalanceAfter(long long balanceCents);
+    void setFailureReason(const std::string& reason);
     
     // Utility
     std::string getFormattedString() const;
+    static long long reserveSequenceNumbers(long long count);  // Returns the first reserved number
+    static std::string makeTransactionId(long long sequenceNumber, std::time_t txnTimestamp);
     static std::string statusToString(TransactionStatus status);
     static std::string typeToString(TransactionType type);
 };
@@ -0,0 +1,593 @@
+#include "TransactionArchive.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <unordered_map>
+
+namespace {
+
+const char ARCHIVE_MAGIC[4] = {'T', 'X', 'A', 'R'};
+const unsigned char ARCHIVE_VERSION = 1;
+const unsigned char BLOCK_MARKER = 'B';
+
+// ID encodings: canonical IDs ("TXN<seq>_<timestamp>") only store the
+// delta-encoded sequence number; anything else is stored verbatim
+const unsigned char ID_CANONICAL = 0;
+const unsigned char ID_RAW = 1;
+
+// Every row takes at least one byte in each of its seven columns, which
+// bounds a block's row count by its payload size
+const std::uint64_t MIN_ROW_BYTES = 7;
+
+// ---- Encoding helpers ----
+
+void putVarint(std::vector<unsigned char>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+void putSigned(std::vector<unsigned char>& out, std::int64_t value) {
+    putVarint(out, zigzag(value));
+}
+
+void putString(std::vector<unsigned char>& out, const std::string& value) {
+    putVarint(out, value.size());
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+// Builds a per-block string dictionary. Index 0 is reserved for "empty" when
+// `reserveEmpty` is set, so optional columns cost a single byte per row.
+class StringDictionary {
+private:
+    std::vector<std::string> values;
+    std::unordered_map<std::string, std::uint64_t> indices;
+    bool reserveEmpty;
+
+public:
+    explicit StringDictionary(bool emptyIsZero) : reserveEmpty(emptyIsZero) {}
+
+    std::uint64_t indexOf(const std::string& value) {
+        if (reserveEmpty && value.empty()) {
+            return 0;
+        }
+        auto it = indices.find(value);
+        if (it != indices.end()) {
+            return it->second;
+        }
+        std::uint64_t index = values.size() + (reserveEmpty ? 1 : 0);
+        values.push_back(value);
+        indices.emplace(value, index);
+        return index;
+    }
+
+    void write(std::vector<unsigned char>& out) const {
+        putVarint(out, values.size());
+        for (const auto& value : values) {
+            putString(out, value);
+        }
+    }
+};
+
+bool parseCanonicalId(const Transaction& txn, std::uint64_t& sequence) {
+    const std::string id = txn.getTransactionId();
+    if (id.compare(0, 3, "TXN") != 0) {
+        return false;
+    }
+    char* end = nullptr;
+    sequence = std::strtoull(id.c_str() + 3, &end, 10);
+    if (end == id.c_str() + 3) {
+        return false;
+    }
+    // Only canonical if the ID can be rebuilt exactly from (sequence, timestamp)
+    return id == "TXN" + std::to_string(sequence) + "_" + std::to_string(txn.getTimestamp());
+}
+
+// ---- Decoding helpers ----
+
+class ByteReader {
+private:
+    const unsigned char* pos;
+    const unsigned char* end;
+    bool ok;
+
+public:
+    ByteReader(const unsigned char* begin, const unsigned char* finish)
+        : pos(begin), end(finish), ok(true) {}
+
+    bool good() const { return ok; }
+    const unsigned char* position() const { return pos; }
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        int shift = 0;
+        while (pos < end && shift < 64) {
+            unsigned char byte = *pos++;
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+            shift += 7;
+        }
+        ok = false;
+        return 0;
+    }
+
+    std::int64_t signedVarint() {
+        return unzigzag(varint());
+    }
+
+    unsigned char byte() {
+        if (pos >= end) {
+            ok = false;
+            return 0;
+        }
+        return *pos++;
+    }
+
+    std::string string() {
+        std::uint64_t length = varint();
+        if (!ok || length > static_cast<std::uint64_t>(end - pos)) {
+            ok = false;
+            return std::string();
+        }
+        std::string value(reinterpret_cast<const char*>(pos), static_cast<std::size_t>(length));
+        pos += length;
+        return value;
+    }
+
+    std::vector<std::string> dictionary(bool emptyIsZero) {
+        std::vector<std::string> values;
+        if (emptyIsZero) {
+            values.emplace_back();
+        }
+        std::uint64_t count = varint();
+        for (std::uint64_t i = 0; ok && i < count; ++i) {
+            values.push_back(string());
+        }
+        return values;
+    }
+
+    void skip(std::uint64_t bytes) {
+        if (bytes > static_cast<std::uint64_t>(end - pos)) {
+            ok = false;
+            pos = end;
+            return;
+        }
+        pos += bytes;
+    }
+};
+
+struct BlockHeader {
+    std::uint64_t rowCount = 0;
+    std::time_t minTimestamp = 0;
+    std::time_t maxTimestamp = 0;
+    long long minAmount = 0;
+    long long maxAmount = 0;
+    std::vector<std::string> accounts;
+    std::uint64_t payloadSize = 0;
+};
+
+bool readBlockHeader(ByteReader& reader, BlockHeader& header) {
+    if (reader.byte() != BLOCK_MARKER) {
+        return false;
+    }
+    header.rowCount = reader.varint();
+    header.minTimestamp = static_cast<std::time_t>(reader.signedVarint());
+    header.maxTimestamp = static_cast<std::time_t>(reader.signedVarint());
+    header.minAmount = reader.signedVarint();
+    header.maxAmount = reader.signedVarint();
+    header.accounts = reader.dictionary(false);
+    header.payloadSize = reader.varint();
+
+    // Reject row counts the payload cannot hold before anything is sized from them
+    return reader.good() && header.rowCount <= header.payloadSize / MIN_ROW_BYTES;
+}
+
+bool blockCanMatch(const BlockHeader& header, const ArchiveScanFilter& filter) {
+    if (header.maxTimestamp < filter.fromTime || header.minTimestamp > filter.toTime) {
+        return false;
+    }
+    if (header.maxAmount < filter.minAmountCents || header.minAmount > filter.maxAmountCents) {
+        return false;
+    }
+    if (!filter.accountNumber.empty() &&
+        std::find(header.accounts.begin(), header.accounts.end(), filter.accountNumber) == header.accounts.end()) {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// ==================== Writer ====================
+
+TransactionArchiveWriter::TransactionArchiveWriter(const std::string& archiveFile, std::size_t blockSize)
+    : archiveFilePath(archiveFile), transactionsPerBlock(blockSize > 0 ? blockSize : 1) {}
+
+TransactionArchiveWriter::~TransactionArchiveWriter() {
+    close();
+}
+
+bool TransactionArchiveWriter::open() {
+    file.open(archiveFilePath, std::ios::binary | std::ios::app | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "Error opening " << archiveFilePath << " for writing." << std::endl;
+        return false;
+    }
+
+    if (file.tellp() == 0) {
+        file.write(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+        file.put(static_cast<char>(ARCHIVE_VERSION));
+        return file.good();
+    }
+
+    // Only append to an archive in this format
+    std::ifstream existing(archiveFilePath, std::ios::binary);
+    char header[sizeof(ARCHIVE_MAGIC) + 1];
+    existing.read(header, sizeof(header));
+    if (!existing || !std::equal(ARCHIVE_MAGIC, ARCHIVE_MAGIC + sizeof(ARCHIVE_MAGIC), header) ||
+        static_cast<unsigned char>(header[sizeof(ARCHIVE_MAGIC)]) != ARCHIVE_VERSION) {
+        std::cerr << archiveFilePath << " is not a supported transaction archive." << std::endl;
+        file.close();
+        return false;
+    }
+    return file.good();
+}
+
+bool TransactionArchiveWriter::append(const Transaction& txn) {
+    pending.push_back(txn);
+    if (pending.size() >= transactionsPerBlock) {
+        return writeBlock();
+    }
+    return true;
+}
+
+bool TransactionArchiveWriter::appendAll(const std::vector<Transaction>& transactions) {
+    for (const auto& txn : transactions) {
+        if (!append(txn)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TransactionArchiveWriter::flush() {
+    if (!pending.empty() && !writeBlock()) {
+        return false;
+    }
+    file.flush();
+    return file.good();
+}
+
+bool TransactionArchiveWriter::close() {
+    if (!file.is_open()) {
+        return true;
+    }
+    bool ok = flush();
+    file.close();
+    return ok;
+}
+
+bool TransactionArchiveWriter::writeBlock() {
+    if (!file.is_open()) {
+        std::cerr << "Archive " << archiveFilePath << " is not open." << std::endl;
+        return false;
+    }
+
+    BlockHeader header;
+    header.rowCount = pending.size();
+    header.minTimestamp = header.maxTimestamp = pending.front().getTimestamp();
+    header.minAmount = header.maxAmount = pending.front().getAmount();
+
+    bool canonicalIds = true;
+    std::vector<std::uint64_t> sequences(pending.size());
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+        const Transaction& txn = pending[i];
+        header.minTimestamp = std::min(header.minTimestamp, txn.getTimestamp());
+        header.maxTimestamp = std::max(header.maxTimestamp, txn.getTimestamp());
+        header.minAmount = std::min(header.minAmount, txn.getAmount());
+        header.maxAmount = std::max(header.maxAmount, txn.getAmount());
+        if (canonicalIds && !parseCanonicalId(txn, sequences[i])) {
+            canonicalIds = false;
+        }
+    }
+
+    // Payload: one column after another
+    StringDictionary accounts(false);
+    StringDictionary relatedAccounts(true);
+    StringDictionary descriptions(true);
+    StringDictionary failureReasons(true);
+    std::vector<unsigned char> accountColumn, relatedColumn, descriptionColumn, failureColumn;
+    for (const auto& txn : pending) {
+        putVarint(accountColumn, accounts.indexOf(txn.getAccountNumber()));
+        putVarint(relatedColumn, relatedAccounts.indexOf(txn.getRelatedAccountNumber()));
+        putVarint(descriptionColumn, descriptions.indexOf(txn.getDescription()));
+        putVarint(failureColumn, failureReasons.indexOf(txn.getFailureReason()));
+    }
+
+    std::vector<unsigned char> payload;
+    payload.push_back(canonicalIds ? ID_CANONICAL : ID_RAW);
+    if (canonicalIds) {
+        std::int64_t previous = 0;
+        for (auto sequence : sequences) {
+            putSigned(payload, static_cast<std::int64_t>(sequence) - previous);
+            previous = static_cast<std::int64_t>(sequence);
+        }
+    } else {
+        for (const auto& txn : pending) {
+            putString(payload, txn.getTransactionId());
+        }
+    }
+
+    std::int64_t previousTimestamp = header.minTimestamp;
+    for (const auto& txn : pending) {
+        putSigned(payload, static_cast<std::int64_t>(txn.getTimestamp()) - previousTimestamp);
+        previousTimestamp = txn.getTimestamp();
+    }
+
+    for (const auto& txn : pending) {
+        putSigned(payload, txn.getAmount());
+    }
+
+    for (const auto& txn : pending) {
+        payload.push_back(static_cast<unsigned char>((static_cast<unsigned>(txn.getType()) << 2) |
+                                                     static_cast<unsigned>(txn.getStatus())));
+    }
+
+    for (const auto& txn : pending) {
+        putSigned(payload, txn.getBalanceAfter());
+    }
+
+    payload.insert(payload.end(), accountColumn.begin(), accountColumn.end());
+    relatedAccounts.write(payload);
+    payload.insert(payload.end(), relatedColumn.begin(), relatedColumn.end());
+    descriptions.write(payload);
+    payload.insert(payload.end(), descriptionColumn.begin(), descriptionColumn.end());
+    failureReasons.write(payload);
+    payload.insert(payload.end(), failureColumn.begin(), failureColumn.end());
+
+    // Header: statistics and account dictionary, readable without the payload
+    std::vector<unsigned char> block;
+    block.push_back(BLOCK_MARKER);
+    putVarint(block, header.rowCount);
+    putSigned(block, header.minTimestamp);
+    putSigned(block, header.maxTimestamp);
+    putSigned(block, header.minAmount);
+    putSigned(block, header.maxAmount);
+    accounts.write(block);
+    putVarint(block, payload.size());
+
+    file.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size()));
+    file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    pending.clear();
+
+    if (!file.good()) {
+        std::cerr << "Error writing block to " << archiveFilePath << "." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ==================== Reader ====================
+
+TransactionArchiveReader::TransactionArchiveReader(const std::string& archiveFile)
+    : archiveFilePath(archiveFile), blocks(0) {}
+
+bool TransactionArchiveReader::load() {
+    std::ifstream file(archiveFilePath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening " << archiveFilePath << " for reading." << std::endl;
+        return false;
+    }
+
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    file.close();
+
+    if (data.size() < sizeof(ARCHIVE_MAGIC) + 1 ||
+        !std::equal(ARCHIVE_MAGIC, ARCHIVE_MAGIC + sizeof(ARCHIVE_MAGIC), data.begin()) ||
+        data[sizeof(ARCHIVE_MAGIC)] != ARCHIVE_VERSION) {
+        std::cerr << archiveFilePath << " is not a supported transaction archive." << std::endl;
+        data.clear();
+        return false;
+    }
+
+    // Walk the block headers once to validate the framing
+    blocks = 0;
+    ByteReader reader(data.data() + sizeof(ARCHIVE_MAGIC) + 1, data.data() + data.size());
+    while (reader.position() < data.data() + data.size()) {
+        BlockHeader header;
+        if (!readBlockHeader(reader, header)) {
+            break;
+        }
+        reader.skip(header.payloadSize);
+        if (!reader.good()) {
+            break;
+        }
+        ++blocks;
+    }
+
+    if (!reader.good()) {
+        std::cerr << "Warning: " << archiveFilePath << " ends with a truncated or corrupt block; "
+                  << blocks << " complete blocks loaded." << std::endl;
+    }
+    return true;
+}
+
+ArchiveScanStats TransactionArchiveReader::scan(const ArchiveScanFilter& filter,
+                                                const std::function<void(const Transaction&)>& visit) const {
+    return scanBlocks(0, filter, visit);
+}
+
+ArchiveScanStats TransactionArchiveReader::scanBlocks(std::size_t firstBlock, const ArchiveScanFilter& filter,
+                                                      const std::function<void(const Transaction&)>& visit) const {
+    ArchiveScanStats stats;
+    if (data.empty()) {
+        return stats;
+    }
+
+    ByteReader reader(data.data() + sizeof(ARCHIVE_MAGIC) + 1, data.data() + data.size());
+    for (std::size_t block = 0; block < blocks; ++block) {
+        BlockHeader header;
+        if (!readBlockHeader(reader, header)) {
+            break;
+        }
+
+        if (block < firstBlock) {
+            reader.skip(header.payloadSize);  // Not requested; not counted as skipped either
+            continue;
+        }
+        if (!blockCanMatch(header, filter)) {
+            reader.skip(header.payloadSize);
+            ++stats.blocksSkipped;
+            continue;
+        }
+        ++stats.blocksScanned;
+
+        const std::size_t rows = static_cast<std::size_t>(header.rowCount);
+        ByteReader payload(reader.position(), reader.position() + header.payloadSize);
+        reader.skip(header.payloadSize);
+
+        // Decode each column into a flat array
+        unsigned char idEncoding = payload.byte();
+        std::vector<std::uint64_t> sequences;
+        std::vector<std::string> rawIds;
+        if (idEncoding == ID_CANONICAL) {
+            sequences.resize(rows);
+            std::int64_t sequence = 0;
+            for (std::size_t i = 0; i < rows; ++i) {
+                sequence += payload.signedVarint();
+                sequences[i] = static_cast<std::uint64_t>(sequence);
+            }
+        } else {
+            rawIds.resize(rows);
+            for (std::size_t i = 0; i < rows; ++i) {
+                rawIds[i] = payload.string();
+            }
+        }
+
+        std::vector<std::time_t> timestamps(rows);
+        std::int64_t timestamp = header.minTimestamp;
+        for (std::size_t i = 0; i < rows; ++i) {
+            timestamp += payload.signedVarint();
+            timestamps[i] = static_cast<std::time_t>(timestamp);
+        }
+
+        std::vector<long long> amounts(rows);
+        for (std::size_t i = 0; i < rows; ++i) {
+            amounts[i] = payload.signedVarint();
+        }
+
+        std::vector<unsigned char> typeStatus(rows);
+        for (std::size_t i = 0; i < rows; ++i) {
+            typeStatus[i] = payload.byte();
+        }
+
+        std::vector<long long> balancesAfter(rows);
+        for (std::size_t i = 0; i < rows; ++i) {
+            balancesAfter[i] = payload.signedVarint();
+        }
+
+        std::vector<std::uint64_t> accountIndices(rows);
+        for (std::size_t i = 0; i < rows; ++i) {
+            accountIndices[i] = payload.varint();
+        }
+
+        std::vector<std::string> relatedAccounts = payload.dictionary(true);
+        std::vector<std::uint64_t> relatedIndices(rows);
+        for (std::size_t i = 0; i < rows; ++i) {
+            relatedIndices[i] = payload.varint();
+        }
+
+        std::vector<std::string> descriptions = payload.dictionary(true);
+        std::vector<std::uint64_t> descriptionIndices(rows);
+        for (std::size_t i = 0; i < rows; ++i) {
+            descriptionIndices[i] = payload.varint();
+        }
+
+        std::vector<std::string> failureReasons = payload.dictionary(true);
+        std::vector<std::uint64_t> failureIndices(rows);
+        for (std::size_t i = 0; i < rows; ++i) {
+            failureIndices[i] = payload.varint();
+        }
+
+        if (!payload.good()) {
+            std::cerr << "Corrupt block in " << archiveFilePath << "; scan stopped." << std::endl;
+            break;
+        }
+
+        // Resolve the account filter to a dictionary index once per block
+        std::uint64_t wantedAccount = 0;
+        if (!filter.accountNumber.empty()) {
+            wantedAccount = static_cast<std::uint64_t>(
+                std::find(header.accounts.begin(), header.accounts.end(), filter.accountNumber) -
+                header.accounts.begin());
+        }
+
+        for (std::size_t i = 0; i < rows; ++i) {
+            if (timestamps[i] < filter.fromTime || timestamps[i] > filter.toTime ||
+                amounts[i] < filter.minAmountCents || amounts[i] > filter.maxAmountCents ||
+                (!filter.accountNumber.empty() && accountIndices[i] != wantedAccount)) {
+                continue;
+            }
+            if (accountIndices[i] >= header.accounts.size() ||
+                relatedIndices[i] >= relatedAccounts.size() ||
+                descriptionIndices[i] >= descriptions.size() ||
+                failureIndices[i] >= failureReasons.size()) {
+                continue;
+            }
+
+            std::string id = idEncoding == ID_CANONICAL
+                ? "TXN" + std::to_string(sequences[i]) + "_" + std::to_string(timestamps[i])
+                : rawIds[i];
+
+            Transaction txn(id, header.accounts[accountIndices[i]], amounts[i],
+                            static_cast<TransactionType>(typeStatus[i] >> 2),
+                            static_cast<TransactionStatus>(typeStatus[i] & 0x3), timestamps[i],
+                            descriptions[descriptionIndices[i]], relatedAccounts[relatedIndices[i]]);
+            txn.setBalanceAfter(balancesAfter[i]);
+            txn.setFailureReason(failureReasons[failureIndices[i]]);
+            ++stats.transactionsMatched;
+            visit(txn);
+        }
+    }
+
+    return stats;
+}
+
+std::vector<Transaction> TransactionArchiveReader::readAll() const {
+    std::vector<Transaction> transactions;
+    scan(ArchiveScanFilter(), [&transactions](const Transaction& txn) {
+        transactions.push_back(txn);
+    });
+    return transactions;
+}
+
+std::size_t TransactionArchiveReader::getBlockCount() const {
+    return blocks;
+}
+
+bool TransactionArchiveReader::getLastTransactionId(std::string& transactionId) const {
+    if (blocks == 0) {
+        return false;
+    }
+
+    bool found = false;
+    scanBlocks(blocks - 1, ArchiveScanFilter(), [&](const Transaction& txn) {
+        transactionId = txn.getTransactionId();
+        found = true;
+    });
+    return found;
+}
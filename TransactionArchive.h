@@ -0,0 +1,91 @@
+#ifndef TRANSACTIONARCHIVE_H
+#define TRANSACTIONARCHIVE_H
+
+#include "Transaction.h"
+#include <cstddef>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Compressed columnar archive for sealed transaction history.
+//
+// Transactions are grouped into blocks. Each block stores its rows column by
+// column: timestamps and IDs are delta-encoded, amounts are varint-encoded,
+// type/status are packed into a single byte, balances-after are varint-encoded,
+// and account numbers, descriptions and failure reasons go through per-block
+// string dictionaries. Every block header carries min/max statistics and its
+// account dictionary so that filtered scans can skip blocks without decoding
+// them.
+
+struct ArchiveScanFilter {
+    std::time_t fromTime = std::numeric_limits<std::time_t>::min();  // Inclusive
+    std::time_t toTime = std::numeric_limits<std::time_t>::max();    // Inclusive
+    long long minAmountCents = std::numeric_limits<long long>::min();
+    long long maxAmountCents = std::numeric_limits<long long>::max();
+    std::string accountNumber;  // Empty matches every account
+};
+
+struct ArchiveScanStats {
+    std::size_t blocksScanned = 0;
+    std::size_t blocksSkipped = 0;
+    std::size_t transactionsMatched = 0;
+};
+
+class TransactionArchiveWriter {
+private:
+    std::string archiveFilePath;
+    std::size_t transactionsPerBlock;
+    std::ofstream file;
+    std::vector<Transaction> pending;
+
+    bool writeBlock();
+
+public:
+    explicit TransactionArchiveWriter(const std::string& archiveFile = "transactions.arc",
+                                      std::size_t blockSize = 4096);
+    ~TransactionArchiveWriter();
+
+    // Opens the archive for appending, writing the file header if it is new
+    bool open();
+
+    // Buffers a transaction; a block is sealed every `blockSize` transactions
+    bool append(const Transaction& txn);
+    bool appendAll(const std::vector<Transaction>& transactions);
+
+    // Seals any buffered transactions into a (possibly short) block
+    bool flush();
+    bool close();
+};
+
+class TransactionArchiveReader {
+private:
+    std::string archiveFilePath;
+    std::vector<unsigned char> data;
+    std::size_t blocks;
+
+    ArchiveScanStats scanBlocks(std::size_t firstBlock, const ArchiveScanFilter& filter,
+                                const std::function<void(const Transaction&)>& visit) const;
+
+public:
+    explicit TransactionArchiveReader(const std::string& archiveFile = "transactions.arc");
+
+    // Reads the archive into memory and validates its header
+    bool load();
+
+    // Calls `visit` for every transaction matching `filter`, skipping blocks
+    // whose statistics rule out a match
+    ArchiveScanStats scan(const ArchiveScanFilter& filter,
+                          const std::function<void(const Transaction&)>& visit) const;
+
+    std::vector<Transaction> readAll() const;
+    std::size_t getBlockCount() const;
+
+    // ID of the newest archived transaction; decodes only the last block.
+    // Returns false if the archive is empty.
+    bool getLastTransactionId(std::string& transactionId) const;
+};
+
+#endif // TRANSACTIONARCHIVE_H
@@ -0,0 +1,119 @@
+#include "VelocityLimiter.h"
+#include <algorithm>
+
+void VelocityLimiter::setRules(const std::vector<VelocityRule>& newRules) {
+    rules = newRules;
+    layouts.clear();
+    bucketsPerAccount = 0;
+    for (auto& rule : rules) {
+        rule.windowSeconds = std::max<std::time_t>(rule.windowSeconds, 1);
+        rule.buckets = static_cast<std::uint32_t>(
+            std::min<std::time_t>(std::max<std::uint32_t>(rule.buckets, 1), rule.windowSeconds));
+        
+        // Rounding the slice up never shortens the window; the extra bucket
+        // keeps the oldest slice counted until all of it is a window old
+        const std::time_t sliceSeconds = (rule.windowSeconds + rule.buckets - 1) / rule.buckets;
+        const auto slices = static_cast<std::uint32_t>((rule.windowSeconds + sliceSeconds - 1) / sliceSeconds);
+        layouts.push_back(RuleLayout{sliceSeconds, slices + 1, bucketsPerAccount});
+        bucketsPerAccount += slices + 1;
+    }
+    
+    slots.clear();
+    lastAccount = nullptr;
+    windows.clear();
+    ringBuckets.clear();
+}
+
+const std::vector<VelocityRule>& VelocityLimiter::getRules() const {
+    return rules;
+}
+
+bool VelocityLimiter::active() const {
+    return !rules.empty();
+}
+
+std::size_t VelocityLimiter::slotFor(const Account& account) {
+    if (&account == lastAccount) {
+        return lastSlot;
+    }
+    
+    auto it = slots.find(&account);
+    if (it == slots.end()) {
+        it = slots.emplace(&account, slots.size()).first;
+        windows.resize(windows.size() + rules.size(), Window{0, 0, 0, 0});
+        ringBuckets.resize(ringBuckets.size() + bucketsPerAccount, Bucket{0, 0});
+    }
+    lastAccount = &account;
+    lastSlot = it->second;
+    return lastSlot;
+}
+
+bool VelocityLimiter::applies(const VelocityRule& rule, VelocityScope kind) {
+    return rule.scope == VelocityScope::ALL_DEBITS || rule.scope == kind;
+}
+
+void VelocityLimiter::advance(std::size_t slot, std::size_t rule, std::time_t now) {
+    Window& window = windows[slot * rules.size() + rule];
+    const std::int64_t epoch = static_cast<std::int64_t>(now / layouts[rule].sliceSeconds);
+    if (epoch <= window.headEpoch) {
+        return;  // Same slice (or the clock stepped back): keep counting into the head
+    }
+    
+    // Rotate out every slice that fell off the back of the window; never
+    // more than one full turn of the ring
+    const std::uint32_t ringSize = layouts[rule].ringSize;
+    Bucket* ring = &ringBuckets[slot * bucketsPerAccount + layouts[rule].bucketOffset];
+    std::int64_t steps = std::min<std::int64_t>(epoch - window.headEpoch, ringSize);
+    std::uint32_t position = window.headBucket;
+    for (std::int64_t i = 0; i < steps; ++i) {
+        position = (position + 1 == ringSize) ? 0 : position + 1;
+        window.amountCents -= ring[position].amountCents;
+        window.count -= ring[position].count;
+        ring[position] = Bucket{0, 0};
+    }
+    window.headEpoch = epoch;
+    window.headBucket = position;
+}
+
+bool VelocityLimiter::allows(const Account& account, VelocityScope kind, long long amountCents, std::time_t now) {
+    if (rules.empty()) {
+        return true;
+    }
+    
+    std::size_t slot = slotFor(account);
+    for (std::size_t r = 0; r < rules.size(); ++r) {
+        const VelocityRule& rule = rules[r];
+        if (!applies(rule, kind)) {
+            continue;
+        }
+        
+        advance(slot, r, now);
+        const Window& window = windows[slot * rules.size() + r];
+        if ((rule.maxAmountCents > 0 && window.amountCents + amountCents > rule.maxAmountCents) ||
+            (rule.maxCount > 0 && window.count + 1 > rule.maxCount)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void VelocityLimiter::record(const Account& account, VelocityScope kind, long long amountCents, std::time_t now) {
+    if (rules.empty()) {
+        return;
+    }
+    
+    std::size_t slot = slotFor(account);
+    for (std::size_t r = 0; r < rules.size(); ++r) {
+        if (!applies(rules[r], kind)) {
+            continue;
+        }
+        
+        advance(slot, r, now);
+        Window& window = windows[slot * rules.size() + r];
+        Bucket& head = ringBuckets[slot * bucketsPerAccount + layouts[r].bucketOffset + window.headBucket];
+        head.amountCents += amountCents;
+        head.count += 1;
+        window.amountCents += amountCents;
+        window.count += 1;
+    }
+}
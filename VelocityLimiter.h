@@ -0,0 +1,86 @@
+#ifndef VELOCITYLIMITER_H
+#define VELOCITYLIMITER_H
+
+#include "Account.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <unordered_map>
+#include <vector>
+
+enum class VelocityScope {
+    WITHDRAWALS,
+    TRANSFERS,
+    ALL_DEBITS      // Withdrawals and outgoing transfers combined
+};
+
+// A limit on how much (and how often) an account may debit within a sliding
+// window, e.g. R5000 per 24 hours. The window is tracked in slices of
+// windowSeconds / buckets seconds, rounded up, and slides in slice steps: a
+// debit counts towards the rule for at least windowSeconds and at most one
+// slice longer, so no windowSeconds-long span ever exceeds the limit.
+struct VelocityRule {
+    VelocityScope scope = VelocityScope::ALL_DEBITS;
+    std::time_t windowSeconds = 24 * 3600;
+    long long maxAmountCents = 0;   // 0 = no amount limit
+    std::uint32_t maxCount = 0;     // 0 = no count limit
+    std::uint32_t buckets = 24;
+};
+
+// Per-account sliding-window debit counters. Each account gets a fixed-size
+// ring of buckets per rule plus a running total, all in flat arrays, so a
+// check reads the running totals and at most rotates a few stale buckets
+// out: its cost does not depend on the account's history.
+class VelocityLimiter {
+private:
+    // Which slice a bucket holds follows from its ring position and the
+    // window's head, so buckets carry only the slice's totals
+    struct Bucket {
+        long long amountCents;
+        std::uint32_t count;
+    };
+    
+    struct Window {
+        std::int64_t headEpoch;     // Newest slice seen (time / slice width)
+        long long amountCents;      // Running totals over the live buckets
+        std::uint32_t count;
+        std::uint32_t headBucket;   // Ring position of headEpoch
+    };
+    
+    // Derived from each rule when the rules are set
+    struct RuleLayout {
+        std::time_t sliceSeconds;
+        std::uint32_t ringSize;     // Slices covering the window, plus the partly elapsed oldest one
+        std::size_t bucketOffset;   // Start of the rule's ring within an account's buckets
+    };
+    
+    std::vector<VelocityRule> rules;
+    std::vector<RuleLayout> layouts;
+    std::size_t bucketsPerAccount = 0;
+    
+    std::unordered_map<const Account*, std::size_t> slots;  // Account -> slot in the arrays below
+    const Account* lastAccount = nullptr;                    // allows() is followed by record() for the
+    std::size_t lastSlot = 0;                                // same account: skip the second lookup
+    std::vector<Window> windows;                             // rules.size() per slot
+    std::vector<Bucket> ringBuckets;                         // bucketsPerAccount per slot
+    
+    std::size_t slotFor(const Account& account);
+    static bool applies(const VelocityRule& rule, VelocityScope kind);
+    void advance(std::size_t slot, std::size_t rule, std::time_t now);
+    
+public:
+    static constexpr bool kEnabled = true;
+    
+    // Replaces the rules and forgets all recorded activity
+    void setRules(const std::vector<VelocityRule>& newRules);
+    const std::vector<VelocityRule>& getRules() const;
+    bool active() const;
+    
+    // True if debiting `amountCents` now keeps the account within every rule for `kind`
+    bool allows(const Account& account, VelocityScope kind, long long amountCents, std::time_t now);
+    
+    // Counts a debit that went through
+    void record(const Account& account, VelocityScope kind, long long amountCents, std::time_t now);
+};
+
+#endif // VELOCITYLIMITER_H
@@ -0,0 +1,203 @@
+#include "Workload.h"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// FNV-1a over the 8 bytes of `value`
+std::uint64_t scatter(std::uint64_t value) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+double zeta(std::uint64_t n, double theta) {
+    double sum = 0.0;
+    for (std::uint64_t i = 1; i <= n; ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i), theta);
+    }
+    return sum;
+}
+
+char opCode(WorkloadOpType type) {
+    switch (type) {
+        case WorkloadOpType::DEPOSIT:
+            return 'D';
+        case WorkloadOpType::WITHDRAWAL:
+            return 'W';
+        case WorkloadOpType::TRANSFER:
+            return 'T';
+        default:
+            return 'S';
+    }
+}
+
+} // namespace
+
+bool OperationMix::isValid() const {
+    return depositPercent >= 0 && withdrawalPercent >= 0 && transferPercent >= 0 && statementPercent >= 0 &&
+           depositPercent + withdrawalPercent + transferPercent + statementPercent == 100;
+}
+
+AccountSelector::AccountSelector(std::uint64_t count, bool useZipfian, double zipfTheta)
+    : accountCount(count > 0 ? count : 1), zipfian(useZipfian), theta(zipfTheta),
+      zetaN(0.0), alpha(0.0), eta(0.0) {
+    if (zipfian) {
+        zetaN = zeta(accountCount, theta);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - std::pow(2.0 / accountCount, 1.0 - theta)) / (1.0 - zeta(2, theta) / zetaN);
+    }
+}
+
+std::uint32_t AccountSelector::next(std::mt19937_64& rng) const {
+    if (!zipfian) {
+        return static_cast<std::uint32_t>(rng() % accountCount);
+    }
+    
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    double uz = u * zetaN;
+    std::uint64_t rank;
+    if (uz < 1.0) {
+        rank = 0;
+    } else if (uz < 1.0 + std::pow(0.5, theta)) {
+        rank = 1;
+    } else {
+        rank = static_cast<std::uint64_t>(accountCount * std::pow(eta * u - eta + 1.0, alpha));
+    }
+    
+    return static_cast<std::uint32_t>(scatter(rank) % accountCount);
+}
+
+WorkloadGenerator::WorkloadGenerator(const AccountSelector& accountSelector, const OperationMix& operationMix,
+                                     double opsPerSecond, long long maxAmount, std::uint64_t seed)
+    : selector(accountSelector), mix(operationMix),
+      meanInterArrivalMicros(opsPerSecond > 0 ? 1e6 / opsPerSecond : 0.0),
+      maxAmountCents(maxAmount > 0 ? maxAmount : 1), rng(seed), clockMicros(0.0) {}
+
+WorkloadOp WorkloadGenerator::next() {
+    WorkloadOp op;
+    
+    // Poisson arrivals: exponential inter-arrival gaps
+    if (meanInterArrivalMicros > 0) {
+        clockMicros += std::exponential_distribution<double>(1.0 / meanInterArrivalMicros)(rng);
+    }
+    op.scheduledMicros = static_cast<std::uint64_t>(clockMicros);
+    
+    int roll = static_cast<int>(rng() % 100);
+    if (roll < mix.depositPercent) {
+        op.type = WorkloadOpType::DEPOSIT;
+    } else if (roll < mix.depositPercent + mix.withdrawalPercent) {
+        op.type = WorkloadOpType::WITHDRAWAL;
+    } else if (roll < mix.depositPercent + mix.withdrawalPercent + mix.transferPercent) {
+        op.type = WorkloadOpType::TRANSFER;
+    } else {
+        op.type = WorkloadOpType::STATEMENT;
+    }
+    
+    op.fromAccount = selector.next(rng);
+    op.toAccount = op.type == WorkloadOpType::TRANSFER ? selector.next(rng) : op.fromAccount;
+    op.amountCents = op.type == WorkloadOpType::STATEMENT
+        ? 0
+        : 1 + static_cast<long long>(rng() % static_cast<std::uint64_t>(maxAmountCents));
+    return op;
+}
+
+bool writeTrace(const std::string& filePath, std::uint64_t accountCount, std::uint32_t streamCount,
+                const std::vector<WorkloadOp>& ops) {
+    std::ofstream file(filePath);
+    if (!file.is_open()) {
+        std::cerr << "Error opening " << filePath << " for writing." << std::endl;
+        return false;
+    }
+    
+    file << "# accounts " << accountCount << '\n';
+    file << "# streams " << streamCount << '\n';
+    for (const auto& op : ops) {
+        file << op.scheduledMicros << ' ' << opCode(op.type) << ' ' << op.fromAccount << ' '
+             << op.toAccount << ' ' << op.amountCents << ' ' << op.stream << '\n';
+    }
+    
+    file.close();
+    return file.good();
+}
+
+bool readTrace(const std::string& filePath, std::uint64_t& accountCount, std::uint32_t& streamCount,
+               std::vector<WorkloadOp>& ops) {
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        std::cerr << "Error opening " << filePath << " for reading." << std::endl;
+        return false;
+    }
+    
+    accountCount = 0;
+    streamCount = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        if (line[0] == '#') {
+            std::istringstream header(line.substr(1));
+            std::string key;
+            if (header >> key && key == "accounts") {
+                header >> accountCount;
+            } else if (key == "streams") {
+                header >> streamCount;
+            }
+            continue;
+        }
+        
+        std::istringstream iss(line);
+        WorkloadOp op;
+        char code;
+        if (!(iss >> op.scheduledMicros >> code >> op.fromAccount >> op.toAccount >> op.amountCents)) {
+            std::cerr << "Skipping malformed trace line: " << line << std::endl;
+            continue;
+        }
+        if (streamCount > 0 && (!(iss >> op.stream) || op.stream >= streamCount)) {
+            std::cerr << "Skipping trace line with a missing or unknown stream: " << line << std::endl;
+            continue;
+        }
+        switch (code) {
+            case 'D':
+                op.type = WorkloadOpType::DEPOSIT;
+                break;
+            case 'W':
+                op.type = WorkloadOpType::WITHDRAWAL;
+                break;
+            case 'T':
+                op.type = WorkloadOpType::TRANSFER;
+                break;
+            default:
+                op.type = WorkloadOpType::STATEMENT;
+                break;
+        }
+        ops.push_back(op);
+    }
+    
+    if (accountCount == 0) {
+        std::cerr << filePath << " has no '# accounts' header." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string workloadOpTypeToString(WorkloadOpType type) {
+    switch (type) {
+        case WorkloadOpType::DEPOSIT:
+            return "DEPOSIT";
+        case WorkloadOpType::WITHDRAWAL:
+            return "WITHDRAWAL";
+        case WorkloadOpType::TRANSFER:
+            return "TRANSFER";
+        case WorkloadOpType::STATEMENT:
+            return "STATEMENT";
+        default:
+            return "UNKNOWN";
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Synthetic workload for capacity testing: account selection with realistic
+// skew, a configurable operation mix, open-loop arrival times, and a
+// replayable trace format.
+
+enum class WorkloadOpType {
+    DEPOSIT,
+    WITHDRAWAL,
+    TRANSFER,
+    STATEMENT,
+    COUNT
+};
+
+struct WorkloadOp {
+    std::uint64_t scheduledMicros;  // Offset from the start of the run; 0 in closed-loop mode
+    WorkloadOpType type;
+    std::uint32_t fromAccount;
+    std::uint32_t toAccount;
+    long long amountCents;
+    std::uint32_t stream = 0;       // Issuing thread, so a replay keeps each thread's sequence
+};
+
+// Percentages; must add up to 100
+struct OperationMix {
+    int depositPercent = 40;
+    int withdrawalPercent = 30;
+    int transferPercent = 25;
+    int statementPercent = 5;
+    
+    bool isValid() const;
+};
+
+// Picks account indices in [0, accountCount), uniformly or Zipf-distributed.
+// Zipfian selection follows Gray et al. ("Quickly Generating Billion-Record
+// Synthetic Databases"), with ranks scattered by a hash so hot accounts are
+// not simply the lowest account numbers.
+class AccountSelector {
+private:
+    std::uint64_t accountCount;
+    bool zipfian;
+    double theta;
+    double zetaN;
+    double alpha;
+    double eta;
+    
+public:
+    // `zipfTheta` must lie in (0, 1) when `useZipfian` is set
+    AccountSelector(std::uint64_t count, bool useZipfian, double zipfTheta = 0.99);
+    
+    std::uint32_t next(std::mt19937_64& rng) const;
+};
+
+class WorkloadGenerator {
+private:
+    const AccountSelector& selector;
+    OperationMix mix;
+    double meanInterArrivalMicros;  // 0 = closed loop
+    long long maxAmountCents;
+    std::mt19937_64 rng;
+    double clockMicros;
+    
+public:
+    // `opsPerSecond` is this generator's share of the arrival rate; 0 = closed loop
+    WorkloadGenerator(const AccountSelector& accountSelector, const OperationMix& operationMix,
+                      double opsPerSecond, long long maxAmount, std::uint64_t seed);
+    
+    WorkloadOp next();
+};
+
+// Trace file: "# accounts <N>" and "# streams <M>" headers, then one
+// operation per line:
+//   <scheduledMicros> <D|W|T|S> <fromAccount> <toAccount> <amountCents> <stream>
+// Traces written before streams were recorded have neither the header nor
+// the last field; readTrace() then reports streamCount = 0.
+bool writeTrace(const std::string& filePath, std::uint64_t accountCount, std::uint32_t streamCount,
+                const std::vector<WorkloadOp>& ops);
+bool readTrace(const std::string& filePath, std::uint64_t& accountCount, std::uint32_t& streamCount,
+               std::vector<WorkloadOp>& ops);
+
+std::string workloadOpTypeToString(WorkloadOpType type);
+
+#endif // WORKLOAD_H
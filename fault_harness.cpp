@@ -0,0 +1,289 @@
+#include "FaultInjector.h"
+#include "Ledger.h"
+#include "ReplicationLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+// Deterministic fault-injection harness.
+//
+// Runs a seeded random workload against a journaled FaultHarnessLedger (a
+// Ledger whose crash points throw SimulatedCrash) while a seeded
+// FaultSchedule injects failures at every FaultPoint. Reports rollback
+// latency, crash-recovery time (rebuilding the ledger from the replication
+// log) and balance-invariant violations.
+//
+// Usage: fault_harness [--ops N] [--accounts N] [--seed S]
+//                      [--checkpoint-every N] [--log FILE]
+
+using Clock = std::chrono::steady_clock;
+
+struct HarnessOptions {
+    std::uint64_t operations = 1000000;
+    int accounts = 1000;
+    std::uint64_t seed = 42;
+    std::uint64_t checkpointEvery = 100000;
+    std::string logFile = "fault_harness.log";
+};
+
+struct LatencyStats {
+    std::vector<double> samples;  // Microseconds
+    
+    void add(double micros) { samples.push_back(micros); }
+    
+    double percentile(double p) {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        std::size_t index = static_cast<std::size_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+    
+    double max() const {
+        return samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end());
+    }
+};
+
+class FaultHarness {
+private:
+    HarnessOptions options;
+    FaultInjector injector;
+    std::mt19937_64 workload;
+    std::unique_ptr<ReplicationLogWriter> journal;
+    std::unique_ptr<FaultHarnessLedger> ledger;
+    std::vector<std::string> accountNumbers;
+    
+    long long expectedTotalCents = 0;  // Sum of balances implied by acknowledged operations
+    std::uint64_t negativeBalanceViolations = 0;
+    std::uint64_t conservationViolations = 0;
+    std::uint64_t rollbackViolations = 0;
+    std::uint64_t crashes = 0;
+    std::uint64_t checkpoints = 0;
+    
+    LatencyStats cleanLatency;
+    LatencyStats rollbackLatency;
+    LatencyStats recoveryLatency;
+    
+    // Starts a new log epoch seeded with the given balances
+    void startEpoch(const std::vector<long long>& balances) {
+        ledger.reset();
+        journal.reset();  // Close the previous log before truncating it
+        journal.reset(new ReplicationLogWriter(options.logFile));
+        ledger.reset(new FaultHarnessLedger());
+        ledger->setJournal(journal.get());
+        for (std::size_t i = 0; i < accountNumbers.size(); ++i) {
+            ledger->createAccount(accountNumbers[i], "Harness " + accountNumbers[i], balances[i]);
+        }
+        
+        // Faults only apply to the workload, not to seeding the epoch
+        ledger->setFaultInjector(&injector);
+        journal->setFaultInjector(&injector);
+    }
+    
+    template <typename LedgerType>
+    std::vector<long long> currentBalances(const LedgerType& source) const {
+        std::vector<long long> balances;
+        for (const auto& accNum : accountNumbers) {
+            std::optional<Account> acc = source.getAccount(accNum);
+            balances.push_back(acc ? acc->getBalance() : 0);
+        }
+        return balances;
+    }
+    
+    void checkInvariants(const std::vector<long long>& balances) {
+        long long total = 0;
+        for (long long balance : balances) {
+            if (balance < 0) {
+                ++negativeBalanceViolations;
+            }
+            total += balance;
+        }
+        if (total != expectedTotalCents) {
+            ++conservationViolations;
+            expectedTotalCents = total;  // Re-baseline so one violation is not counted forever
+        }
+    }
+    
+    void recoverFromCrash() {
+        ++crashes;
+        
+        // The in-memory ledger died with the process; rebuild from the durable log
+        auto start = Clock::now();
+        ReplicaLedger recovered(options.logFile);
+        recovered.poll();
+        std::vector<long long> balances = currentBalances(recovered.getLedger());
+        recoveryLatency.add(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        
+        checkInvariants(balances);
+        startEpoch(balances);
+    }
+    
+    void runOperation() {
+        const std::string& from = accountNumbers[workload() % accountNumbers.size()];
+        const std::string& to = accountNumbers[workload() % accountNumbers.size()];
+        const long long amount = 1 + static_cast<long long>(workload() % 50000);
+        const unsigned kind = static_cast<unsigned>(workload() % 10);
+        
+        const long long fromBefore = ledger->getAccount(from)->getBalance();
+        const long long toBefore = ledger->getAccount(to)->getBalance();
+        const std::uint64_t firedBefore = injector.getTotalFired();
+        
+        auto start = Clock::now();
+        bool ok;
+        if (kind < 4) {
+            ok = ledger->deposit(from, amount, "Harness deposit");
+            if (ok) {
+                expectedTotalCents += amount;
+            }
+        } else if (kind < 7) {
+            ok = ledger->withdrawal(from, amount, "Harness withdrawal");
+            if (ok) {
+                expectedTotalCents -= amount;
+            }
+        } else {
+            ok = ledger->transfer(from, to, amount, "Harness transfer");
+        }
+        double micros = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        
+        if (injector.getTotalFired() == firedBefore) {
+            cleanLatency.add(micros);
+            return;
+        }
+        
+        // A fault fired: a failed transfer must leave both balances untouched
+        rollbackLatency.add(micros);
+        if (kind >= 7 && !ok &&
+            (ledger->getAccount(from)->getBalance() != fromBefore ||
+             ledger->getAccount(to)->getBalance() != toBefore)) {
+            ++rollbackViolations;
+        }
+    }
+    
+public:
+    FaultHarness(const HarnessOptions& harnessOptions, const FaultSchedule& schedule)
+        : options(harnessOptions), injector(schedule), workload(harnessOptions.seed ^ 0x9E3779B97F4A7C15ULL) {
+        for (int i = 0; i < options.accounts; ++i) {
+            accountNumbers.push_back("ACC" + std::to_string(i));
+        }
+        std::vector<long long> balances(accountNumbers.size(), 100000);  // R1000 each
+        expectedTotalCents = 100000LL * options.accounts;
+        startEpoch(balances);
+    }
+    
+    void run() {
+        auto start = Clock::now();
+        for (std::uint64_t op = 1; op <= options.operations; ++op) {
+            try {
+                runOperation();
+            } catch (const SimulatedCrash&) {
+                recoverFromCrash();
+            }
+            
+            // Periodic checkpoint: verify invariants and start a fresh epoch,
+            // which bounds log size and recovery time
+            if (options.checkpointEvery > 0 && op % options.checkpointEvery == 0) {
+                std::vector<long long> balances = currentBalances(*ledger);
+                checkInvariants(balances);
+                startEpoch(balances);
+                ++checkpoints;
+            }
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        
+        checkInvariants(currentBalances(*ledger));
+        report(seconds);
+    }
+    
+    void report(double seconds) {
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "\n" << std::string(70, '=') << std::endl;
+        std::cout << "FAULT INJECTION REPORT (seed " << options.seed << ")" << std::endl;
+        std::cout << std::string(70, '=') << std::endl;
+        std::cout << "Operations:        " << options.operations << " in " << seconds << " s ("
+                  << (options.operations / seconds) << " ops/s)" << std::endl;
+        std::cout << "Checkpoints:       " << checkpoints << std::endl;
+        
+        std::cout << "\n" << std::left << std::setw(28) << "Fault point"
+                  << std::right << std::setw(14) << "Hits" << std::setw(12) << "Fired" << std::endl;
+        std::cout << std::string(54, '-') << std::endl;
+        for (int i = 0; i < static_cast<int>(FaultPoint::COUNT); ++i) {
+            FaultPoint point = static_cast<FaultPoint>(i);
+            std::cout << std::left << std::setw(28) << FaultInjector::pointToString(point)
+                      << std::right << std::setw(14) << injector.getHits(point)
+                      << std::setw(12) << injector.getFired(point) << std::endl;
+        }
+        
+        std::cout << "\nLatency (us)          p50        p99        max    samples" << std::endl;
+        std::cout << std::string(62, '-') << std::endl;
+        printLatency("Clean operations", cleanLatency);
+        printLatency("Faulted/rolled back", rollbackLatency);
+        printLatency("Crash recovery", recoveryLatency);
+        
+        std::cout << "\nCrashes recovered:          " << crashes << std::endl;
+        std::cout << "Negative balances:          " << negativeBalanceViolations << std::endl;
+        std::cout << "Conservation violations:    " << conservationViolations << std::endl;
+        std::cout << "Incomplete rollbacks:       " << rollbackViolations << std::endl;
+        std::cout << std::string(70, '=') << std::endl;
+    }
+    
+    void printLatency(const std::string& label, LatencyStats& stats) {
+        std::cout << std::left << std::setw(20) << label << std::right
+                  << std::setw(10) << stats.percentile(0.50)
+                  << std::setw(11) << stats.percentile(0.99)
+                  << std::setw(11) << stats.max()
+                  << std::setw(11) << stats.samples.size() << std::endl;
+    }
+    
+    std::uint64_t violations() const {
+        return negativeBalanceViolations + conservationViolations + rollbackViolations;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    HarnessOptions options;
+    for (int i = 1; i < argc; i += 2) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Option " << flag << " expects a value" << std::endl;
+            return 2;
+        }
+        std::string value = argv[i + 1];
+        if (flag == "--ops") {
+            options.operations = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (flag == "--accounts") {
+            options.accounts = std::max(1, std::atoi(value.c_str()));
+        } else if (flag == "--seed") {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (flag == "--checkpoint-every") {
+            options.checkpointEvery = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (flag == "--log") {
+            options.logFile = value;
+        } else {
+            std::cerr << "Unknown option " << flag << std::endl;
+            return 2;
+        }
+    }
+    
+    // Failure storm: frequent transfer failures, rarer crashes
+    FaultSchedule schedule(options.seed);
+    schedule.setProbability(FaultPoint::TRANSFER_BEFORE_DEBIT, 1000)
+            .setProbability(FaultPoint::TRANSFER_AFTER_DEBIT, 1000)
+            .setProbability(FaultPoint::TRANSFER_AFTER_CREDIT, 1000)
+            .setProbability(FaultPoint::ROLLBACK_RESTORE_SENDER, 10000)
+            .setProbability(FaultPoint::ROLLBACK_REMOVE_RECIPIENT, 10000)
+            .setProbability(FaultPoint::PERSIST_BEFORE_WRITE, 10)
+            .setProbability(FaultPoint::PERSIST_TORN_WRITE, 10);
+    
+    FaultHarness harness(options, schedule);
+    harness.run();
+    
+    return harness.violations() == 0 ? 0 : 1;
+}
@@ -0,0 +1,727 @@
+#include "AsyncLogWriter.h"
+#include "AuditLog.h"
+#include "FaultInjector.h"
+#include "Ledger.h"
+#include "PersistenceManager.h"
+#include "ReplicationLog.h"
+#include "Sha256.h"
+#include "TransactionArchive.h"
+#include "Workload.h"
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Behaviour checks for the ledger's storage, replication and policy
+// features. Prints one line per check and exits non-zero if any failed.
+// Scratch files are created (and removed) in the working directory.
+//
+// Usage: ledger_tests
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& description) {
+    std::cout << (condition ? "[PASS] " : "[FAIL] ") << description << std::endl;
+    if (!condition) {
+        ++failures;
+    }
+}
+
+void removeFiles(std::initializer_list<std::string> paths) {
+    for (const auto& path : paths) {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+    }
+}
+
+bool sameTransaction(const Transaction& a, const Transaction& b) {
+    return a.getTransactionId() == b.getTransactionId() && a.getAccountNumber() == b.getAccountNumber() &&
+           a.getAmount() == b.getAmount() && a.getType() == b.getType() && a.getStatus() == b.getStatus() &&
+           a.getTimestamp() == b.getTimestamp() && a.getDescription() == b.getDescription() &&
+           a.getRelatedAccountNumber() == b.getRelatedAccountNumber() &&
+           a.getBalanceAfter() == b.getBalanceAfter() && a.getFailureReason() == b.getFailureReason();
+}
+
+bool sameHistory(const std::vector<Transaction>& a, const std::vector<Transaction>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (!sameTransaction(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==================== Transaction archive ====================
+
+void testArchive() {
+    const std::string archiveFile = "ledger_tests.arc";
+    removeFiles({archiveFile});
+    
+    Ledger ledger;
+    ledger.createAccount("ACC001", "Archive Holder", 10000);
+    ledger.createAccount("ACC002", "Archive Payee", 0);
+    ledger.deposit("ACC001", 2500, "Salary | March");
+    ledger.transfer("ACC001", "ACC002", 1200, "Rent");
+    ledger.withdrawal("ACC002", 99999, "More than the balance");
+    
+    PersistenceManager persistence("ledger_tests.dat", "ledger_tests.log");
+    check(persistence.archiveTransactions(ledger, archiveFile), "archive: write history");
+    
+    TransactionArchiveReader reader(archiveFile);
+    check(reader.load() && sameHistory(reader.readAll(), ledger.getTransactionHistory()),
+          "archive: round trip preserves every field");
+    
+    ledger.deposit("ACC002", 300, "Refund");
+    bool archivedTwice = persistence.archiveTransactions(ledger, archiveFile) &&
+                         persistence.archiveTransactions(ledger, archiveFile);
+    TransactionArchiveReader again(archiveFile);
+    check(archivedTwice && again.load() && sameHistory(again.readAll(), ledger.getTransactionHistory()),
+          "archive: archiving again appends only new transactions");
+    
+    // A block header claiming 2^40 rows in a 16-byte payload
+    const unsigned char corrupt[] = {'T', 'X', 'A', 'R', 1, 'B', 0x80, 0x80, 0x80, 0x80, 0x80, 0x20,
+                                     0, 0, 0, 0, 0, 16, 0, 0, 0, 0, 0, 0, 0, 0,
+                                     0, 0, 0, 0, 0, 0, 0, 0};
+    {
+        std::ofstream file(archiveFile, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(corrupt), sizeof(corrupt));
+    }
+    TransactionArchiveReader damaged(archiveFile);
+    check(damaged.load() && damaged.getBlockCount() == 0 && damaged.readAll().empty(),
+          "archive: corrupt row count is rejected before allocating");
+    
+    removeFiles({archiveFile});
+}
+
+// ==================== SHA-256 ====================
+
+void testSha256() {
+    // FIPS 180-4 / NIST example vectors, on the portable path and (where
+    // the CPU has them) the SHA extensions
+    const std::string twoBlocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    const std::string pieces(997, 'a');
+    for (bool portable : {true, false}) {
+        Sha256::forcePortable(portable);
+        const std::string path = Sha256::hardwareAccelerated() ? "SHA extensions" : "portable";
+        check(Sha256::toHex(Sha256::hash("", 0)) ==
+                  "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" &&
+              Sha256::toHex(Sha256::hash("abc", 3)) ==
+                  "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" &&
+              Sha256::toHex(Sha256::hash(twoBlocks.data(), twoBlocks.size())) ==
+                  "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+              "sha256: known-answer vectors (" + path + ")");
+        
+        // One million 'a's in uneven pieces, so updates straddle block boundaries
+        Sha256 hasher;
+        std::size_t remaining = 1000000;
+        while (remaining > 0) {
+            std::size_t length = std::min(remaining, pieces.size());
+            hasher.update(pieces.data(), length);
+            remaining -= length;
+        }
+        check(Sha256::toHex(hasher.finish()) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0",
+              "sha256: incremental updates match the one-million-'a' vector (" + path + ")");
+    }
+}
+
+// ==================== Asynchronous log writer ====================
+
+std::string fileContents(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Writes the same records through `backend`, including one larger than the
+// 4 KiB buffer, and returns what reached the file; the destructor drains
+// whatever is still pending
+std::string writeRecords(const std::string& path, AsyncLogWriter::Backend backend,
+                         AsyncLogWriter::Backend& used) {
+    {
+        AsyncLogWriter log(path, true, 4096, backend);
+        used = log.getBackend();
+        for (int i = 0; i < 500; ++i) {
+            log.append("Record " + std::to_string(i) + "\n");
+        }
+        log.append(std::string(10000, 'x') + "\n");
+        log.append("Tail\n");
+    }
+    return fileContents(path);
+}
+
+void testAsyncLogWriter() {
+    const std::string logFile = "ledger_tests_async.log";
+    removeFiles({logFile});
+    
+    {
+        AsyncLogWriter log(logFile, true, 4096);
+        std::uint64_t first = log.append("alpha\n");
+        std::uint64_t second = log.append("beta\n");
+        bool durable = log.waitDurable(second);
+        check(first == 1 && second == 2 && log.getAppendedSequence() == 2 && durable &&
+              log.getDurableSequence() >= 2 && fileContents(logFile) == "alpha\nbeta\n",
+              "async log: sequence numbers count appends and waitDurable returns once the data is in the file");
+        
+        const std::string large(3 * 4096 + 17, 'L');
+        std::uint64_t sequence = log.append(large);
+        check(sequence == 3 && log.waitDurable(sequence) && fileContents(logFile) == "alpha\nbeta\n" + large,
+              "async log: a record larger than the buffer is written whole");
+    }
+    
+    std::string expected;
+    for (int i = 0; i < 500; ++i) {
+        expected += "Record " + std::to_string(i) + "\n";
+    }
+    expected += std::string(10000, 'x') + "\nTail\n";
+    AsyncLogWriter::Backend uringUsed = AsyncLogWriter::Backend::PWRITE;
+    AsyncLogWriter::Backend pwriteUsed = AsyncLogWriter::Backend::IO_URING;
+    std::string viaUring = writeRecords(logFile, AsyncLogWriter::Backend::IO_URING, uringUsed);
+    std::string viaPwrite = writeRecords(logFile, AsyncLogWriter::Backend::PWRITE, pwriteUsed);
+    check(viaUring == expected && viaPwrite == expected && pwriteUsed == AsyncLogWriter::Backend::PWRITE,
+          std::string("async log: the destructor drains pending appends, identically with io_uring") +
+              (uringUsed == AsyncLogWriter::Backend::IO_URING ? "" : " (unavailable here)") + " and pwrite");
+    
+    // Every write to /dev/full fails with ENOSPC
+    if (std::filesystem::exists("/dev/full")) {
+        AsyncLogWriter full("/dev/full", false, 4096);
+        std::uint64_t sequence = full.append("lost\n");
+        bool durable = full.waitDurable(sequence);
+        check(full.isOpen() && sequence == 1 && !durable && full.append("after\n") == 0,
+              "async log: after a failed write waitDurable fails and append returns 0");
+    }
+    
+    removeFiles({logFile});
+}
+
+// ==================== Audit log ====================
+
+void testAuditLog() {
+    const std::string logFile = "ledger_tests_audit.log";
+    const std::string checkpointFile = AuditLogWriter::checkpointPathFor(logFile);
+    removeFiles({logFile, checkpointFile});
+    
+    {
+        AuditLogWriter writer(logFile, 4);
+        check(writer.open(), "audit: open a new log");
+        for (int i = 0; i < 6; ++i) {
+            writer.append("Record " + std::to_string(i));
+        }
+    }
+    {
+        // A crash in the middle of the seventh record
+        std::ofstream file(logFile, std::ios::app | std::ios::binary);
+        file << "Record 6 0123";
+    }
+    AuditVerifyReport report;
+    {
+        AuditLogWriter writer(logFile, 4);
+        check(writer.open() && writer.getRecordCount() == 6 && writer.append("Record 6") && writer.close() &&
+              verifyAuditLog(logFile, 2, report) && report.records == 7,
+              "audit: a torn last record is truncated and appending resumes");
+    }
+    removeFiles({logFile, checkpointFile});
+    
+    {
+        // Written before the hash chain: plain lines and no checkpoint file
+        std::ofstream file(logFile, std::ios::binary);
+        file << "[2024-01-01 09:00:00] ID: TXN1_0 | Type: DEPOSIT | Amount: R10.00 | Status: COMPLETED\n"
+             << "[2024-01-01 09:05:00] ID: TXN2_0 | Type: WITHDRAWAL | Amount: R5.00 | Status: COMPLETED";
+    }
+    {
+        AuditLogWriter writer(logFile, 4);
+        check(!writer.open() && !verifyAuditLog(logFile, 2, report) && !std::filesystem::exists(checkpointFile),
+              "audit: a legacy log is refused until it is migrated");
+    }
+    check(AuditLogWriter::migrateLegacyLog(logFile) && !AuditLogWriter::migrateLegacyLog(logFile),
+          "audit: legacy migration is explicit and runs once");
+    {
+        AuditLogWriter writer(logFile, 4);
+        check(writer.open() && writer.getRecordCount() == 2 && writer.append("After migration") &&
+              writer.close() && verifyAuditLog(logFile, 2, report) && report.segments == 1 && report.records == 3,
+              "audit: a legacy log is sealed as a genesis segment and the chain continues");
+    }
+    {
+        std::fstream file(logFile, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(1);
+        file.put('3');
+    }
+    check(!verifyAuditLog(logFile, 2, report) && report.problem.find("segment 0") == 0,
+          "audit: an edited legacy record is detected");
+    removeFiles({logFile, checkpointFile});
+    
+    {
+        AuditLogWriter writer(logFile, 4);
+        writer.open();
+        writer.append("Record 0");
+        writer.append("Record 1");
+    }
+    {
+        // Edit the first record and delete the checkpoints
+        std::fstream file(logFile, std::ios::in | std::ios::out | std::ios::binary);
+        file.put('X');
+    }
+    removeFiles({checkpointFile});
+    {
+        AuditLogWriter writer(logFile, 4);
+        check(!writer.open() && !AuditLogWriter::migrateLegacyLog(logFile) && !verifyAuditLog(logFile, 2, report) &&
+              !std::filesystem::exists(checkpointFile),
+              "audit: a chained log without its checkpoint file is refused, not re-sealed as legacy");
+    }
+    
+    removeFiles({logFile, checkpointFile});
+    Ledger ledger;
+    ledger.createAccount("ACC001", "Audit Holder", 10000);
+    ledger.deposit("ACC001", 500, "Salary");
+    ledger.withdrawal("ACC001", 200, "ATM");
+    PersistenceManager persistence("ledger_tests.dat", logFile);
+    bool savedTwice = persistence.saveTransactions(ledger) && persistence.saveTransactions(ledger);
+    ledger.deposit("ACC001", 300, "Refund");
+    check(savedTwice && persistence.saveTransactions(ledger) && verifyAuditLog(logFile, 2, report) &&
+          report.records == ledger.getTransactionHistory().size(),
+          "audit: saving again appends only new transactions");
+    
+    removeFiles({logFile, checkpointFile});
+}
+
+// ==================== Workload traces ====================
+
+void testTrace() {
+    const std::string traceFile = "ledger_tests.trace";
+    std::vector<WorkloadOp> ops;
+    for (std::uint32_t i = 0; i < 6; ++i) {
+        WorkloadOp op{i * 10, WorkloadOpType::TRANSFER, i, i + 1, 100 + i};
+        op.stream = i % 3;
+        ops.push_back(op);
+    }
+    
+    std::uint64_t accounts = 0;
+    std::uint32_t streams = 0;
+    std::vector<WorkloadOp> read;
+    bool sameStreams = writeTrace(traceFile, 50, 3, ops) && readTrace(traceFile, accounts, streams, read) &&
+                       accounts == 50 && streams == 3 && read.size() == ops.size();
+    for (std::size_t i = 0; sameStreams && i < ops.size(); ++i) {
+        sameStreams = read[i].stream == ops[i].stream && read[i].fromAccount == ops[i].fromAccount;
+    }
+    check(sameStreams, "trace: each operation keeps its issuing stream");
+    removeFiles({traceFile});
+}
+
+// ==================== Accruals ====================
+
+void testAccruals() {
+    Ledger ledger;
+    for (int i = 0; i < 10; ++i) {
+        ledger.createAccount("ACC00" + std::to_string(i), "Accrual " + std::to_string(i), 10000 * (10 - i));
+    }
+    ledger.deposit("ACC009", 500, "Before accruals");
+    
+    RateSchedule schedule;
+    schedule.tiers.push_back(RateTier{0, 3650});
+    schedule.accrualDays = 30;
+    schedule.chargeMonthlyFee = true;
+    schedule.monthlyFeeCents = 2000;
+    schedule.feeWaiverBalanceCents = 50000;
+    AccrualSummary summary = ledger.postAccruals(schedule, 3);
+    
+    // The balance index was rebuilt in bulk: it must list every account in order
+    std::vector<Account> largest = ledger.getLargestBalances(10);
+    bool ordered = largest.size() == 10;
+    for (std::size_t i = 0; ordered && i < largest.size(); ++i) {
+        ordered = ledger.getAccount(largest[i].getAccountNumber())->getBalance() == largest[i].getBalance() &&
+                  (i == 0 || largest[i - 1].getBalance() >= largest[i].getBalance());
+    }
+    check(summary.accountsProcessed == 10 && ordered, "accruals: balance index matches the posted balances");
+    
+    // ...and the timeline links each posting after the account's earlier entries
+    std::vector<Transaction> statement = ledger.getAccountTransactions("ACC009");
+    check(statement.size() == 3 && statement[0].getType() == TransactionType::DEPOSIT &&
+          statement[1].getType() == TransactionType::INTEREST_CREDIT &&
+          statement[2].getType() == TransactionType::FEE_DEBIT &&
+          statement[2].getBalanceAfter() == ledger.getAccount("ACC009")->getBalance(),
+          "accruals: postings are linked into each account's timeline");
+    
+    const std::size_t historySize = ledger.getTransactionHistory().size();
+    const long long balance = ledger.getAccount("ACC000")->getBalance();
+    schedule.daysInYear = 0;
+    summary = ledger.postAccruals(schedule, 3);
+    check(summary.accountsProcessed == 0 && ledger.getTransactionHistory().size() == historySize &&
+          ledger.getAccount("ACC000")->getBalance() == balance,
+          "accruals: a schedule without days in the year is rejected and posts nothing");
+}
+
+// ==================== Time-travel balances ====================
+
+void testBalanceAt() {
+    // Replayed entries carry their own timestamps: one every 10 s from t0 + 10
+    const std::time_t t0 = 1700000000;
+    Ledger ledger;
+    ledger.replayAccount("ACC001", "Time Traveller", 1000, t0);
+    for (int i = 1; i <= 200; ++i) {
+        Transaction txn("TXN" + std::to_string(i) + "_0", "ACC001", 1, TransactionType::DEPOSIT,
+                        TransactionStatus::COMPLETED, t0 + 10 * i, "Replayed");
+        ledger.replayTransaction(txn, 1000 + i);
+    }
+    
+    long long balance = 0;
+    check(!ledger.balanceAt("ACC001", t0 - 1, balance), "balanceAt: false before the account was opened");
+    check(ledger.balanceAt("ACC001", t0 + 5, balance) && balance == 1000,
+          "balanceAt: opening balance before the first entry");
+    bool everyPoint = true;
+    for (int i : {1, 63, 64, 65, 128, 150, 199, 200}) {
+        everyPoint = everyPoint && ledger.balanceAt("ACC001", t0 + 10 * i, balance) && balance == 1000 + i &&
+                     ledger.balanceAt("ACC001", t0 + 10 * i + 9, balance) && balance == 1000 + i;
+    }
+    check(everyPoint, "balanceAt: running balance on both sides of checkpoints");
+    check(ledger.balanceAt("ACC001", t0 + 100000, balance) && balance == 1200,
+          "balanceAt: latest balance after the last entry");
+    
+    Ledger live;
+    live.createAccount("ACC002", "Live Holder", 500);
+    live.deposit("ACC002", 250, "Today");
+    check(live.balanceAt("ACC002", std::time(nullptr) + 1, balance) && balance == 750,
+          "balanceAt: matches the live balance now");
+    
+    BatchLedger batch;
+    batch.createAccount("ACC003", "Batch Holder", 500);
+    check(!batch.balanceAt("ACC003", std::time(nullptr) + 1, balance), "balanceAt: unavailable without history");
+}
+
+// ==================== Secondary indexes ====================
+
+// Account numbers joined with commas, optionally sorted (for ties)
+std::string accountNumbers(const std::vector<Account>& accounts, bool sorted = false) {
+    std::vector<std::string> numbers;
+    for (const auto& account : accounts) {
+        numbers.push_back(account.getAccountNumber());
+    }
+    if (sorted) {
+        std::sort(numbers.begin(), numbers.end());
+    }
+    std::string joined;
+    for (const auto& number : numbers) {
+        joined += (joined.empty() ? "" : ",") + number;
+    }
+    return joined;
+}
+
+void testIndex() {
+    Ledger ledger;
+    ledger.createAccount("ACC001", "alice Smith", 5000);
+    ledger.createAccount("ACC002", "Alicia Keys", 3000);
+    ledger.createAccount("ACC003", "ALI Baba", 3000);
+    ledger.createAccount("ACC004", "Bob", 1000);
+    ledger.createAccount("ACC005", "Albert", 8000);
+    
+    check(accountNumbers(ledger.findAccountsByHolder("aLi")) == "ACC003,ACC001,ACC002" &&
+          accountNumbers(ledger.findAccountsByHolder("ALI", 2)) == "ACC003,ACC001" &&
+          accountNumbers(ledger.findAccountsByHolder("al")) == "ACC005,ACC003,ACC001,ACC002" &&
+          ledger.findAccountsByHolder("Carol").empty(),
+          "index: holder prefixes match case-insensitively, in name order, up to the limit");
+    
+    std::vector<Account> tied = ledger.getAccountsInBalanceRange(3000, 5000);
+    check(tied.size() == 3 && accountNumbers({tied[0], tied[1]}, true) == "ACC002,ACC003" &&
+          tied[2].getAccountNumber() == "ACC001" &&
+          accountNumbers(ledger.getAccountsInBalanceRange(3000, 3000), true) == "ACC002,ACC003" &&
+          ledger.getAccountsInBalanceRange(3001, 4999).empty() &&
+          ledger.getAccountsInBalanceRange(1000, 8000, 2).size() == 2,
+          "index: balance ranges include both bounds and every account with an equal balance");
+    check(accountNumbers(ledger.getLargestBalances(2)) == "ACC005,ACC001",
+          "index: largest balances, largest first");
+    
+    ledger.deposit("ACC004", 7500, "Bonus");
+    bool afterDeposit = accountNumbers(ledger.getLargestBalances(1)) == "ACC004";
+    ledger.withdrawal("ACC005", 500, "ATM");
+    bool afterWithdrawal = accountNumbers(ledger.getAccountsInBalanceRange(7500, 7500)) == "ACC005";
+    ledger.transfer("ACC004", "ACC002", 8000, "Rent");
+    bool afterTransfer = accountNumbers(ledger.getLargestBalances(1)) == "ACC002" &&
+                         accountNumbers(ledger.getAccountsInBalanceRange(0, 600)) == "ACC004";
+    check(afterDeposit && afterWithdrawal && afterTransfer,
+          "index: deposits, withdrawals and transfers re-file the accounts they touch");
+    
+    FaultInjector injector(FaultSchedule().failOnHit(FaultPoint::TRANSFER_AFTER_CREDIT, 1));
+    ledger.setFaultInjector(&injector);
+    bool rolledBack = !ledger.transfer("ACC002", "ACC001", 6000, "Commit fails");
+    ledger.setFaultInjector(nullptr);
+    check(rolledBack && accountNumbers(ledger.getAccountsInBalanceRange(11000, 11000)) == "ACC002" &&
+          accountNumbers(ledger.getAccountsInBalanceRange(5000, 5000)) == "ACC001" &&
+          ledger.getAccountsInBalanceRange(5001, 10999).size() == 1,
+          "index: a rolled-back transfer leaves both accounts where they were");
+    
+    std::uint64_t holdId = 0;
+    ledger.placeHold("ACC002", 4000, std::time(nullptr) + 3600, holdId, "Hotel");
+    bool unchangedByHold = accountNumbers(ledger.getLargestBalances(1)) == "ACC002";
+    ledger.captureHold(holdId, 4000, "Checkout");
+    check(unchangedByHold && accountNumbers(ledger.getLargestBalances(2)) == "ACC005,ACC002" &&
+          accountNumbers(ledger.getAccountsInBalanceRange(7000, 7000)) == "ACC002",
+          "index: holds only re-file an account when they are captured");
+}
+
+// ==================== Authorization holds ====================
+
+void testHolds() {
+    const std::time_t now = std::time(nullptr);
+    Ledger ledger;
+    ledger.createAccount("ACC001", "Hold Holder", 10000);
+    
+    std::uint64_t captured = 0;
+    bool placed = ledger.placeHold("ACC001", 3000, now + 3600, captured, "Hotel");
+    bool reserved = ledger.getAccount("ACC001")->getAvailableBalance() == 7000;
+    check(placed && reserved && ledger.captureHold(captured, 2500, "Checkout") &&
+          ledger.getAccount("ACC001")->getBalance() == 7500 &&
+          ledger.getAccount("ACC001")->getAvailableBalance() == 7500 && ledger.getOpenHoldCount() == 0,
+          "holds: capture debits the captured amount and releases the rest");
+    
+    std::uint64_t declined = 0;
+    std::uint64_t next = 0;
+    check(!ledger.placeHold("ACC001", 999999, now + 3600, declined, "Too much") && declined == 0 &&
+          ledger.placeHold("ACC001", 1000, now + 10, next, "Expiring") && next == captured + 1,
+          "holds: a declined hold does not use up a hold ID");
+    
+    std::size_t early = ledger.processExpiredHolds(now + 5);
+    std::size_t due = ledger.processExpiredHolds(now + 10);
+    std::vector<Transaction> statement = ledger.getAccountTransactions("ACC001");
+    check(early == 0 && due == 1 && ledger.getOpenHoldCount() == 0 &&
+          ledger.getAccount("ACC001")->getAvailableBalance() == 7500 &&
+          statement.back().getType() == TransactionType::HOLD_EXPIRY,
+          "holds: an uncaptured hold expires at its deadline");
+    
+    BatchLedger batch;
+    batch.createAccount("ACC001", "Batch Holder", 10000);
+    std::uint64_t batchHold = 0;
+    check(!batch.placeHold("ACC001", 100, now + 3600, batchHold) &&
+          batch.getAccount("ACC001")->getAvailableBalance() == 10000,
+          "holds: BatchLedger has no holds");
+}
+
+// ==================== Velocity limits ====================
+
+void testVelocity() {
+    const std::string archiveFile = "ledger_tests_velocity.arc";
+    removeFiles({archiveFile});
+    
+    Ledger ledger;
+    ledger.createAccount("ACC001", "Velocity Holder", 100000);
+    ledger.createAccount("ACC002", "Velocity Payee", 0);
+    ledger.setVelocityLimits({VelocityRule{VelocityScope::ALL_DEBITS, 3600, 5000, 0, 60}});
+    
+    bool allowed = ledger.withdrawal("ACC001", 3000, "ATM");
+    bool rejected = !ledger.withdrawal("ACC001", 2500, "Groceries");
+    const Transaction last = ledger.getTransactionHistory().back();
+    check(allowed && rejected && ledger.getAccount("ACC001")->getBalance() == 97000 &&
+          last.getStatus() == TransactionStatus::FAILED && last.getDescription() == "Groceries" &&
+          last.getFailureReason() == "Velocity limit exceeded",
+          "velocity: a rejected debit keeps the caller's reason and records the cause");
+    
+    bool transferRejected = !ledger.transfer("ACC001", "ACC002", 2500, "Rent");
+    const std::vector<Transaction> history = ledger.getTransactionHistory();
+    const Transaction& debit = history[history.size() - 2];
+    check(transferRejected && ledger.getAccount("ACC002")->getBalance() == 0 && debit.getDescription() == "Rent" &&
+          debit.getFailureReason() == "Velocity limit exceeded" &&
+          ledger.withdrawal("ACC001", 2000, "Within the limit"),
+          "velocity: transfers count against the same window");
+    
+    // The rollback simulation reports the recorded cause instead of guessing one
+    std::ostringstream output;
+    std::streambuf* previous = std::cout.rdbuf(output.rdbuf());
+    bool simulationRejected = !ledger.transferWithFailureSimulation("ACC001", "ACC002", 2500, false, "Simulated");
+    std::cout.rdbuf(previous);
+    check(simulationRejected && output.str().find("Transfer rejected: Velocity limit exceeded.") != std::string::npos,
+          "velocity: a simulated transfer prints the recorded failure reason");
+    
+    PersistenceManager persistence("ledger_tests.dat", "ledger_tests.log");
+    TransactionArchiveReader reader(archiveFile);
+    check(persistence.archiveTransactions(ledger, archiveFile) && reader.load() &&
+          sameHistory(reader.readAll(), ledger.getTransactionHistory()),
+          "velocity: failure reasons survive archiving");
+    
+    // 10 s in 3 buckets: 4 s slices, so the window never comes up short
+    Account account("ACC003", "Slice Holder", 0);
+    VelocityLimiter limiter;
+    limiter.setRules({VelocityRule{VelocityScope::WITHDRAWALS, 10, 1000, 0, 3}});
+    limiter.record(account, VelocityScope::WITHDRAWALS, 1000, 100);
+    check(!limiter.allows(account, VelocityScope::WITHDRAWALS, 1, 109) &&
+          limiter.allows(account, VelocityScope::WITHDRAWALS, 1, 116),
+          "velocity: a debit counts for the whole window when the slices do not divide it");
+    
+    BatchLedger batch;
+    batch.createAccount("ACC001", "Batch Holder", 100000);
+    batch.setVelocityLimits({VelocityRule{VelocityScope::ALL_DEBITS, 3600, 5000, 0, 60}});
+    check(batch.withdrawal("ACC001", 3000) && batch.withdrawal("ACC001", 2500) &&
+          batch.getAccount("ACC001")->getBalance() == 94500,
+          "velocity: BatchLedger has no velocity limits");
+    
+    removeFiles({archiveFile});
+}
+
+// ==================== Fault policies ====================
+
+void testFaultPolicies() {
+    FaultInjector injector(FaultSchedule().failOnHit(FaultPoint::TRANSFER_AFTER_CREDIT, 1)
+                                          .failOnHit(FaultPoint::ROLLBACK_REMOVE_RECIPIENT, 1));
+    Ledger ledger;
+    ledger.createAccount("ACC001", "Fault Sender", 1000);
+    ledger.createAccount("ACC002", "Fault Recipient", 0);
+    ledger.setFaultInjector(&injector);
+    bool threw = false;
+    bool transferred = true;
+    try {
+        transferred = ledger.transfer("ACC001", "ACC002", 400, "Commit fails");
+    } catch (const SimulatedCrash&) {
+        threw = true;
+    }
+    check(!threw && !transferred && ledger.getAccount("ACC001")->getBalance() == 1000 &&
+          ledger.getAccount("ACC002")->getBalance() == 0,
+          "faults: Ledger rolls back and never throws at crash points");
+    
+    injector.reset();
+    FaultHarnessLedger harnessLedger;
+    harnessLedger.createAccount("ACC001", "Fault Sender", 1000);
+    harnessLedger.createAccount("ACC002", "Fault Recipient", 0);
+    harnessLedger.setFaultInjector(&injector);
+    threw = false;
+    try {
+        harnessLedger.transfer("ACC001", "ACC002", 400, "Commit fails");
+    } catch (const SimulatedCrash& crash) {
+        threw = crash.getPoint() == FaultPoint::ROLLBACK_REMOVE_RECIPIENT;
+    }
+    check(threw, "faults: FaultHarnessLedger crashes at a due crash point");
+}
+
+// ==================== Concurrent ledger ====================
+
+void testConcurrentLedger() {
+    ConcurrentLedger ledger;
+    ledger.createAccount("ACC001", "Snapshot Holder", 1000);
+    std::optional<Account> before = ledger.getAccount("ACC001");
+    ledger.deposit("ACC001", 500, "After the snapshot");
+    check(before && before->getBalance() == 1000 && ledger.getAccount("ACC001")->getBalance() == 1500 &&
+          !ledger.getAccount("ACC404"),
+          "concurrent: getAccount returns a snapshot taken under the lock");
+    check(ledger.waitDurable(ledger.getJournalSequence()), "concurrent: waitDurable without a journal");
+}
+
+// ==================== Read replicas ====================
+
+bool sameBalances(const Ledger& primary, const Ledger& replica, std::initializer_list<std::string> accounts) {
+    for (const auto& accountNumber : accounts) {
+        std::optional<Account> expected = primary.getAccount(accountNumber);
+        std::optional<Account> actual = replica.getAccount(accountNumber);
+        if (!expected || !actual || expected->getBalance() != actual->getBalance()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testReplica() {
+    const std::string logFile = "ledger_tests_replication.log";
+    removeFiles({logFile});
+    
+    std::unique_ptr<ReplicationLogWriter> writer(new ReplicationLogWriter(logFile));
+    std::unique_ptr<Ledger> primary(new Ledger());
+    primary->setJournal(writer.get());
+    primary->createAccount("ACC001", "Replica Holder", 10000);
+    primary->createAccount("ACC002", "Replica Payee", 500);
+    primary->deposit("ACC001", 2500, "Salary");
+    primary->transfer("ACC001", "ACC002", 1200, "Rent");
+    primary->waitDurable(primary->getJournalSequence());
+    
+    ReplicaLedger replica(logFile);
+    replica.poll();
+    check(sameBalances(*primary, replica.getLedger(), {"ACC001", "ACC002"}) &&
+          replica.getStatus().appliedSequence == primary->getJournalSequence(),
+          "replica: catches up with the primary");
+    
+    // Restart the primary with a longer log than the replica has read
+    primary.reset();
+    writer.reset(new ReplicationLogWriter(logFile));
+    primary.reset(new Ledger());
+    primary->setJournal(writer.get());
+    primary->createAccount("ACC001", "Replica Holder", 700);
+    primary->createAccount("ACC002", "Replica Payee", 0);
+    primary->createAccount("ACC003", "Replica Third", 0);
+    for (int i = 0; i < 5; ++i) {
+        primary->transfer("ACC001", "ACC003", 100, "Restart transfer " + std::to_string(i));
+    }
+    primary->waitDurable(primary->getJournalSequence());
+    replica.poll();
+    {
+        // A transfer torn halfway through its record must leave both accounts as they were
+        std::ofstream file(logFile, std::ios::app);
+        file << "X|" << (primary->getJournalSequence() + 1) << "|0|TXN1_0|ACC001|100|";
+    }
+    replica.poll();
+    check(replica.getStatus().epochs == 1 &&
+          sameBalances(*primary, replica.getLedger(), {"ACC001", "ACC002", "ACC003"}),
+          "replica: restart detected by epoch header, torn transfer record not applied");
+    primary.reset();
+    writer.reset();
+    
+    // Open times come from the primary, not from when the replica applied the record
+    {
+        std::ofstream file(logFile, std::ios::trunc);
+        file << "E|42|0\n"
+             << "A|1|0|ACC009|Old Account|5000|1000000000\n";
+    }
+    ReplicaLedger dated(logFile);
+    dated.poll();
+    long long balance = 0;
+    check(dated.getLedger().balanceAt("ACC009", 1000000000, balance) && balance == 5000 &&
+          !dated.getLedger().balanceAt("ACC009", 999999999, balance),
+          "replica: balanceAt uses the primary's account open time");
+    
+    // A duplicated deposit must not be applied twice, nor wipe the replica
+    const std::string deposit = "T|2|0|TXN1_0|ACC009|100|0|1|1000000000|5100||Deposit|\n";
+    {
+        std::ofstream file(logFile, std::ios::app);
+        file << deposit << deposit;
+    }
+    dated.poll();
+    dated.poll();
+    {
+        std::ofstream file(logFile, std::ios::app);
+        file << "A|3|0|ACC010|After Duplicate|100|1000000000\n";
+    }
+    dated.poll();
+    check(dated.getStatus().outOfOrder == 1 && dated.getStatus().appliedSequence == 3 &&
+          dated.getLedger().getAccount("ACC009")->getBalance() == 5100 &&
+          dated.getLedger().getAccount("ACC010")->getBalance() == 100 &&
+          dated.getLedger().getTransactionHistory().size() == 1,
+          "replica: a repeated sequence number is skipped and later records still apply");
+    
+    removeFiles({logFile});
+}
+
+} // namespace
+
+int main() {
+    testArchive();
+    testSha256();
+    testAsyncLogWriter();
+    testAuditLog();
+    testTrace();
+    testAccruals();
+    testBalanceAt();
+    testIndex();
+    testHolds();
+    testVelocity();
+    testFaultPolicies();
+    testConcurrentLedger();
+    testReplica();
+    
+    std::cout << (failures == 0 ? "All checks passed." : std::to_string(failures) + " check(s) failed.")
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
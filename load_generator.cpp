@@ -0,0 +1,313 @@
+#include "Ledger.h"
+#include "Workload.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Synthetic load generator for capacity testing.
+//
+// Creates N accounts in a ConcurrentLedger and drives a configurable mix of
+// deposits, withdrawals, transfers and statement reads from M threads.
+// With --rate, arrivals are open-loop (Poisson) and latency is measured from
+// each operation's scheduled start, so a stalled ledger shows up as queueing
+// delay instead of silently lowering the offered load. Traces record each
+// operation's issuing thread, and --replay re-runs every recorded thread's
+// sequence on its own thread (so --threads is ignored when replaying).
+//
+// Usage: load_generator [--accounts N] [--ops N] [--threads M] [--rate OPS_PER_SEC]
+//                       [--dist zipf|uniform] [--theta T] [--mix D,W,T,S]
+//                       [--initial-balance CENTS] [--max-amount CENTS] [--seed S]
+//                       [--trace-out FILE] [--replay FILE]
+//                       [--daily-limit CENTS] [--hourly-limit CENTS]
+
+using Clock = std::chrono::steady_clock;
+
+struct LoadOptions {
+    std::uint64_t accounts = 100000;
+    std::uint64_t operations = 1000000;
+    unsigned threads = 4;
+    double rate = 0.0;  // Total ops/s; 0 = closed loop
+    bool zipfian = true;
+    double theta = 0.99;
+    OperationMix mix;
+    long long initialBalanceCents = 1000000;
+    long long maxAmountCents = 50000;
+    std::uint64_t seed = 1;
+    std::string traceOut;
+    std::string replay;
+    long long dailyLimitCents = 0;   // Velocity limits on debits; 0 = none
+    long long hourlyLimitCents = 0;
+};
+
+bool parseMix(const std::string& value, OperationMix& mix) {
+    std::istringstream iss(value);
+    char comma1, comma2, comma3;
+    return (iss >> mix.depositPercent >> comma1 >> mix.withdrawalPercent >> comma2
+                >> mix.transferPercent >> comma3 >> mix.statementPercent) &&
+           comma1 == ',' && comma2 == ',' && comma3 == ',' && mix.isValid();
+}
+
+bool parseOptions(int argc, char* argv[], LoadOptions& options) {
+    for (int i = 1; i < argc; i += 2) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Option " << flag << " expects a value" << std::endl;
+            return false;
+        }
+        std::string value = argv[i + 1];
+        if (flag == "--accounts") {
+            options.accounts = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (flag == "--ops") {
+            options.operations = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (flag == "--threads") {
+            options.threads = std::max(1, std::atoi(value.c_str()));
+        } else if (flag == "--rate") {
+            options.rate = std::atof(value.c_str());
+        } else if (flag == "--dist") {
+            if (value != "zipf" && value != "uniform") {
+                std::cerr << "--dist expects zipf or uniform" << std::endl;
+                return false;
+            }
+            options.zipfian = (value == "zipf");
+        } else if (flag == "--theta") {
+            options.theta = std::atof(value.c_str());
+            // The Zipf generator raises to 1 / (1 - theta)
+            if (!(options.theta > 0.0 && options.theta < 1.0)) {
+                std::cerr << "--theta must be between 0 and 1 (exclusive)" << std::endl;
+                return false;
+            }
+        } else if (flag == "--mix") {
+            if (!parseMix(value, options.mix)) {
+                std::cerr << "--mix expects four percentages adding up to 100, e.g. 40,30,25,5" << std::endl;
+                return false;
+            }
+        } else if (flag == "--initial-balance") {
+            options.initialBalanceCents = std::atoll(value.c_str());
+        } else if (flag == "--max-amount") {
+            options.maxAmountCents = std::atoll(value.c_str());
+        } else if (flag == "--seed") {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (flag == "--trace-out") {
+            options.traceOut = value;
+        } else if (flag == "--replay") {
+            options.replay = value;
+        } else if (flag == "--daily-limit") {
+            options.dailyLimitCents = std::atoll(value.c_str());
+        } else if (flag == "--hourly-limit") {
+            options.hourlyLimitCents = std::atoll(value.c_str());
+        } else {
+            std::cerr << "Unknown option " << flag << std::endl;
+            return false;
+        }
+    }
+    if (options.accounts == 0 || options.accounts > 0xFFFFFFFFULL) {
+        std::cerr << "--accounts must be between 1 and 4294967295" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+double percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::size_t index = static_cast<std::size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+void printLatencyRow(const std::string& label, std::vector<double>& samples) {
+    std::cout << std::left << std::setw(12) << label << std::right
+              << std::setw(11) << samples.size()
+              << std::setw(10) << percentile(samples, 0.50)
+              << std::setw(10) << percentile(samples, 0.90)
+              << std::setw(10) << percentile(samples, 0.99)
+              << std::setw(10) << percentile(samples, 0.999)
+              << std::setw(11) << (samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end()))
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+    
+    // Build the per-thread operation streams up front so generation cost is not measured
+    std::vector<std::vector<WorkloadOp>> streams(options.threads);
+    bool openLoop = options.rate > 0;
+    if (!options.replay.empty()) {
+        std::vector<WorkloadOp> trace;
+        std::uint32_t streamCount = 0;
+        if (!readTrace(options.replay, options.accounts, streamCount, trace)) {
+            return 1;
+        }
+        options.operations = trace.size();
+        openLoop = !trace.empty() && trace.back().scheduledMicros > 0;  // Closed-loop traces are untimed
+        if (streamCount > 0) {
+            // Same threads, same per-thread order as the recorded run
+            options.threads = streamCount;
+            streams.assign(streamCount, {});
+            for (const auto& op : trace) {
+                streams[op.stream].push_back(op);
+            }
+        } else {
+            std::cout << options.replay << " does not record streams; spreading it over "
+                      << options.threads << " threads" << std::endl;
+            for (std::size_t i = 0; i < trace.size(); ++i) {
+                streams[i % options.threads].push_back(trace[i]);
+            }
+        }
+        std::cout << "Replaying " << trace.size() << " operations from " << options.replay << " on "
+                  << options.threads << " threads" << std::endl;
+    } else {
+        AccountSelector selector(options.accounts, options.zipfian, options.theta);
+        for (unsigned t = 0; t < options.threads; ++t) {
+            WorkloadGenerator generator(selector, options.mix, options.rate / options.threads,
+                                        options.maxAmountCents, options.seed + t);
+            std::uint64_t share = options.operations / options.threads +
+                                  (t < options.operations % options.threads ? 1 : 0);
+            streams[t].reserve(share);
+            for (std::uint64_t i = 0; i < share; ++i) {
+                streams[t].push_back(generator.next());
+                streams[t].back().stream = t;
+            }
+        }
+    }
+    
+    if (!options.traceOut.empty()) {
+        std::vector<WorkloadOp> trace;
+        for (const auto& stream : streams) {
+            trace.insert(trace.end(), stream.begin(), stream.end());
+        }
+        std::stable_sort(trace.begin(), trace.end(), [](const WorkloadOp& a, const WorkloadOp& b) {
+            return a.scheduledMicros < b.scheduledMicros;
+        });
+        if (writeTrace(options.traceOut, options.accounts, static_cast<std::uint32_t>(streams.size()), trace)) {
+            std::cout << "Trace written to " << options.traceOut << std::endl;
+        }
+    }
+    
+    ConcurrentLedger ledger;
+    std::vector<VelocityRule> limits;
+    if (options.dailyLimitCents > 0) {
+        limits.push_back(VelocityRule{VelocityScope::ALL_DEBITS, 24 * 3600, options.dailyLimitCents, 0, 24});
+    }
+    if (options.hourlyLimitCents > 0) {
+        limits.push_back(VelocityRule{VelocityScope::ALL_DEBITS, 3600, options.hourlyLimitCents, 0, 60});
+    }
+    ledger.setVelocityLimits(limits);
+    
+    std::vector<std::string> accountNumbers(options.accounts);
+    for (std::uint64_t i = 0; i < options.accounts; ++i) {
+        accountNumbers[i] = "ACC" + std::to_string(i);
+        ledger.createAccount(accountNumbers[i], "Load " + std::to_string(i), options.initialBalanceCents);
+    }
+    
+    const int kTypes = static_cast<int>(WorkloadOpType::COUNT);
+    std::vector<std::vector<std::vector<double>>> latencies(
+        options.threads, std::vector<std::vector<double>>(kTypes));
+    std::vector<std::uint64_t> rejected(options.threads, 0);
+    
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    Clock::time_point start;
+    for (unsigned t = 0; t < options.threads; ++t) {
+        workers.emplace_back([&, t]() {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            
+            for (const auto& op : streams[t]) {
+                Clock::time_point issued = Clock::now();
+                if (openLoop) {
+                    Clock::time_point scheduled = start + std::chrono::microseconds(op.scheduledMicros);
+                    if (scheduled > issued) {
+                        std::this_thread::sleep_until(scheduled);
+                    }
+                    issued = scheduled;  // Queueing delay counts towards latency
+                }
+                
+                const std::string& from = accountNumbers[op.fromAccount % options.accounts];
+                const std::string& to = accountNumbers[op.toAccount % options.accounts];
+                bool ok = true;
+                switch (op.type) {
+                    case WorkloadOpType::DEPOSIT:
+                        ok = ledger.deposit(from, op.amountCents, "Load deposit");
+                        break;
+                    case WorkloadOpType::WITHDRAWAL:
+                        ok = ledger.withdrawal(from, op.amountCents, "Load withdrawal");
+                        break;
+                    case WorkloadOpType::TRANSFER:
+                        ok = ledger.transfer(from, to, op.amountCents, "Load transfer");
+                        break;
+                    default:
+                        ledger.getAccountTransactions(from);
+                        break;
+                }
+                if (!ok) {
+                    ++rejected[t];
+                }
+                
+                latencies[t][static_cast<int>(op.type)].push_back(
+                    std::chrono::duration<double, std::micro>(Clock::now() - issued).count());
+            }
+        });
+    }
+    
+    start = Clock::now() + std::chrono::milliseconds(10);
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    
+    // Merge per-thread results
+    std::vector<std::vector<double>> byType(kTypes);
+    std::vector<double> all;
+    std::uint64_t rejectedTotal = 0;
+    for (unsigned t = 0; t < options.threads; ++t) {
+        for (int k = 0; k < kTypes; ++k) {
+            byType[k].insert(byType[k].end(), latencies[t][k].begin(), latencies[t][k].end());
+            all.insert(all.end(), latencies[t][k].begin(), latencies[t][k].end());
+        }
+        rejectedTotal += rejected[t];
+    }
+    
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n" << std::string(75, '=') << std::endl;
+    std::cout << "LOAD GENERATOR REPORT" << std::endl;
+    std::cout << std::string(75, '=') << std::endl;
+    std::cout << "Accounts:      " << options.accounts
+              << (options.replay.empty() ? (options.zipfian ? " (zipfian, theta " + std::to_string(options.theta) + ")"
+                                                            : " (uniform)")
+                                         : " (replay)") << std::endl;
+    std::cout << "Threads:       " << options.threads << std::endl;
+    std::cout << "Arrivals:      " << (openLoop ? "open loop" : "closed loop");
+    if (openLoop && options.replay.empty()) {
+        std::cout << " at " << options.rate << " ops/s offered";
+    }
+    std::cout << std::endl;
+    std::cout << "Completed:     " << all.size() << " ops in " << std::setprecision(3) << seconds << " s = "
+              << std::setprecision(1) << (all.size() / seconds) << " ops/s" << std::endl;
+    std::cout << "Rejected:      " << rejectedTotal << " (insufficient funds or invalid)" << std::endl;
+    
+    std::cout << "\nLatency (us) " << std::right << std::setw(10) << "count" << std::setw(10) << "p50"
+              << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+              << std::setw(11) << "max" << std::endl;
+    std::cout << std::string(75, '-') << std::endl;
+    for (int k = 0; k < kTypes; ++k) {
+        printLatencyRow(workloadOpTypeToString(static_cast<WorkloadOpType>(k)), byType[k]);
+    }
+    printLatencyRow("ALL", all);
+    std::cout << std::string(75, '=') << std::endl;
+    
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "Ledger.h"
+#include "ReplicationLog.h"
 #include <iostream>
 #include <iomanip>
 #include <limits>
@@ -28,6 +29,10 @@ int main() {
     Ledger ledger;
     int choice;
     
+    // Ship every change to read replicas (see banking_replica)
+    ReplicationLogWriter replicationLog("replication.log");
+    ledger.setJournal(&replicationLog);
+    
     // Create sample accounts
     ledger.createAccount("ACC001", "John Mandela", 50000);      // R500
     ledger.createAccount("ACC002", "Thabo Mthembu", 100000);    // R1000
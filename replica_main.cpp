@@ -0,0 +1,77 @@
+#include "ReplicationLog.h"
+#include <iostream>
+#include <limits>
+
+// Read-only replica: tails the primary's replication log and serves
+// statement queries from its own Ledger.
+
+void clearInputBuffer() {
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+}
+
+void displayReplicaMenu() {
+    std::cout << "\n" << std::string(60, '=') << std::endl;
+    std::cout << "        BANKING LEDGER SYSTEM - READ REPLICA" << std::endl;
+    std::cout << std::string(60, '=') << std::endl;
+    std::cout << "1. View All Accounts" << std::endl;
+    std::cout << "2. View Account Statement" << std::endl;
+    std::cout << "3. View Transaction History" << std::endl;
+    std::cout << "4. Replication Status" << std::endl;
+    std::cout << "5. Exit" << std::endl;
+    std::cout << std::string(60, '=') << std::endl;
+    std::cout << "Enter your choice: ";
+}
+
+int main(int argc, char* argv[]) {
+    std::string logFile = argc > 1 ? argv[1] : "replication.log";
+    ReplicaLedger replica(logFile);
+    int choice;
+
+    std::cout << "\nReplica tailing " << logFile << std::endl;
+
+    while (true) {
+        displayReplicaMenu();
+        std::cin >> choice;
+        clearInputBuffer();
+
+        if (!std::cin) {
+            break;
+        }
+
+        // Catch up with the primary before serving each query
+        replica.poll();
+
+        if (choice == 1) {
+            replica.getLedger().displayAllAccounts();
+        }
+        else if (choice == 2) {
+            std::string accNum;
+            std::cout << "\nEnter account number: ";
+            std::getline(std::cin, accNum);
+
+            replica.getLedger().displayAccountStatement(accNum);
+        }
+        else if (choice == 3) {
+            replica.getLedger().displayTransactionHistory();
+        }
+        else if (choice == 4) {
+            ReplicationStatus status = replica.getStatus();
+            std::cout << "\n--- REPLICATION STATUS ---" << std::endl;
+            std::cout << "Applied sequence: " << status.appliedSequence << std::endl;
+            std::cout << "Applied records:  " << status.appliedRecords << std::endl;
+            std::cout << "Pending bytes:    " << status.pendingBytes << std::endl;
+            std::cout << "Lag:              " << status.lagMillis << " ms" << std::endl;
+            std::cout << "Primary restarts: " << status.epochs << std::endl;
+            std::cout << "Out of order:     " << status.outOfOrder << std::endl;
+        }
+        else if (choice == 5) {
+            std::cout << "\nReplica shutting down. Goodbye!" << std::endl;
+            break;
+        }
+        else {
+            std::cout << "Invalid choice. Please try again." << std::endl;
+        }
+    }
+
+    return 0;
+}
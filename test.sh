@@ -4,6 +4,7 @@
 # This demonstrates the application functionality
 
 cd "$(dirname "$0")"
+BUILD_DIR="${BUILD_DIR:-build}"
 
 echo "================================"
 echo "Banking Ledger System - Test Run"
@@ -11,7 +12,7 @@ echo "================================"
 echo ""
 
 # Check if binary exists
-if [ ! -f "build/banking_ledger" ]; then
+if [ ! -f "$BUILD_DIR/banking_ledger" ]; then
     echo "Error: banking_ledger binary not found!"
     echo "Please run: cmake .. && make in the build directory"
     exit 1
@@ -77,9 +78,25 @@ echo ""
     # Exit
     echo "9"
     
-) | ./build/banking_ledger
+) | "./$BUILD_DIR/banking_ledger"
+
+# Behaviour checks: each prints [PASS]/[FAIL] lines and exits non-zero on failure
+echo ""
+echo "Running behaviour checks..."
+FAILED=0
+
+(cd "$BUILD_DIR" && ./ledger_tests) || FAILED=1
+
+echo ""
+echo "Running fault harness (default schedule)..."
+(cd "$BUILD_DIR" && ./fault_harness) || FAILED=1
 
 echo ""
 echo "================================"
+if [ "$FAILED" -ne 0 ]; then
+    echo "Test FAILED"
+    echo "================================"
+    exit 1
+fi
 echo "Test completed successfully!"
 echo "================================"